@@ -0,0 +1,670 @@
+/**
+ * These codes are licensed under the Unlicense.
+ * http://unlicense.org
+ */
+
+#ifndef COMMATA_GUARD_50EC6EE0_BB72_497E_9C57_A31E5D800803
+#define COMMATA_GUARD_50EC6EE0_BB72_497E_9C57_A31E5D800803
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "field_scanners.hpp"
+#include "detail/member_like_base.hpp"
+
+namespace commata {
+
+namespace detail::column {
+
+// A validity bitmap in the layout of Apache Arrow, which is not allocated
+// until the first null is pushed
+template <class Allocator>
+class validity_bitmap
+{
+    using a_t = typename std::allocator_traits<Allocator>::
+        template rebind_alloc<std::uint8_t>;
+
+    std::vector<std::uint8_t, a_t> bits_;
+    std::size_t null_count_;
+
+public:
+    explicit validity_bitmap(const Allocator& alloc) noexcept :
+        bits_(a_t(alloc)), null_count_(0)
+    {}
+
+    const std::uint8_t* data() const noexcept
+    {
+        return bits_.empty() ? nullptr : bits_.data();
+    }
+
+    bool is_valid(std::size_t i) const noexcept
+    {
+        return bits_.empty() || ((bits_[i / 8] >> (i % 8)) & 1U);
+    }
+
+    std::size_t null_count() const noexcept
+    {
+        return null_count_;
+    }
+
+    void reserve(std::size_t n)
+    {
+        if (!bits_.empty()) {
+            bits_.reserve(byte_count(n));                       // throw
+        }
+    }
+
+    // n is the number of the values before this value is pushed and
+    // capacity is that of the values
+    void push_valid(std::size_t n)
+    {
+        if (!bits_.empty()) {
+            push(n, true);                                      // throw
+        }
+    }
+
+    void push_null(std::size_t n, std::size_t capacity)
+    {
+        if (bits_.empty()) {
+            // All values so far are valid
+            bits_.reserve(byte_count(capacity));                // throw
+            bits_.assign(n / 8, 0xFFU);
+            if (n % 8 != 0) {
+                bits_.push_back(
+                    static_cast<std::uint8_t>((1U << (n % 8)) - 1));
+            }
+        }
+        push(n, false);                                         // throw
+        ++null_count_;
+    }
+
+    void clear() noexcept
+    {
+        bits_.clear();
+        null_count_ = 0;
+    }
+
+    void swap(validity_bitmap& other) noexcept
+    {
+        using std::swap;
+        bits_.swap(other.bits_);
+        swap(null_count_, other.null_count_);
+    }
+
+private:
+    static std::size_t byte_count(std::size_t n) noexcept
+    {
+        return n / 8 + ((n % 8 != 0) ? 1 : 0);
+    }
+
+    void push(std::size_t n, bool valid)
+    {
+        if (n % 8 == 0) {
+            bits_.push_back(0);                                 // throw
+        }
+        if (valid) {
+            bits_.back() |= static_cast<std::uint8_t>(1U << (n % 8));
+        }
+    }
+};
+
+// Grows the capacity in bulk rather than by std::vector's own policy so
+// that values are appended mostly without checking for reallocation
+constexpr std::size_t min_bulk_capacity = 1024;
+
+inline std::size_t next_capacity(std::size_t capacity) noexcept
+{
+    return std::max(min_bulk_capacity, capacity * 2);
+}
+
+} // end detail::column
+
+// A contiguous buffer of values of a column with a validity bitmap, whose
+// layout is that of Apache Arrow's primitive arrays: the i-th value is valid
+// if and only if the (i % 8)-th least significant bit of the (i / 8)-th byte
+// of the bitmap is set
+template <class T, class Allocator = std::allocator<T>>
+class column_buffer
+{
+    static_assert(std::is_trivially_copyable_v<T>);
+
+    std::vector<T, Allocator> values_;
+    detail::column::validity_bitmap<Allocator> validity_;
+
+public:
+    using value_type = T;
+    using allocator_type = Allocator;
+    using size_type = typename std::vector<T, Allocator>::size_type;
+    using const_iterator = typename std::vector<T, Allocator>::const_iterator;
+
+    static constexpr size_type min_bulk_capacity =
+        detail::column::min_bulk_capacity;
+
+    column_buffer() noexcept(std::is_nothrow_default_constructible_v<
+                                Allocator>) :
+        column_buffer(Allocator())
+    {}
+
+    explicit column_buffer(const Allocator& alloc) noexcept :
+        values_(alloc), validity_(alloc)
+    {}
+
+    column_buffer(const column_buffer&) = default;
+    column_buffer(column_buffer&&) = default;
+    ~column_buffer() = default;
+    column_buffer& operator=(const column_buffer&) = default;
+    column_buffer& operator=(column_buffer&&) = default;
+
+    allocator_type get_allocator() const noexcept
+    {
+        return values_.get_allocator();
+    }
+
+    size_type size() const noexcept
+    {
+        return values_.size();
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return values_.empty();
+    }
+
+    size_type capacity() const noexcept
+    {
+        return values_.capacity();
+    }
+
+    void reserve(size_type n)
+    {
+        values_.reserve(n);                                     // throw
+        validity_.reserve(n);                                   // throw
+    }
+
+    const T* data() const noexcept
+    {
+        return values_.data();
+    }
+
+    T* data() noexcept
+    {
+        return values_.data();
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return values_.cbegin();
+    }
+
+    const_iterator end() const noexcept
+    {
+        return values_.cend();
+    }
+
+    const T& operator[](size_type i) const noexcept
+    {
+        assert(i < size());
+        return values_[i];
+    }
+
+    // Returns a null pointer when there are no nulls
+    const std::uint8_t* validity_bitmap() const noexcept
+    {
+        return validity_.data();
+    }
+
+    bool is_valid(size_type i) const noexcept
+    {
+        assert(i < size());
+        return validity_.is_valid(i);
+    }
+
+    size_type null_count() const noexcept
+    {
+        return validity_.null_count();
+    }
+
+    void push_back(const T& value)
+    {
+        grow();                                                 // throw
+        validity_.push_valid(size());                           // throw
+        values_.push_back(value);
+    }
+
+    void push_null()
+    {
+        grow();                                                 // throw
+        validity_.push_null(size(), capacity());                // throw
+        values_.emplace_back();
+    }
+
+    void clear() noexcept
+    {
+        values_.clear();
+        validity_.clear();
+    }
+
+    void swap(column_buffer& other)
+        noexcept(std::allocator_traits<Allocator>::
+                    propagate_on_container_swap::value
+              || std::allocator_traits<Allocator>::is_always_equal::value)
+    {
+        values_.swap(other.values_);
+        validity_.swap(other.validity_);
+    }
+
+private:
+    void grow()
+    {
+        if (size() == capacity()) {
+            reserve(detail::column::next_capacity(capacity())); // throw
+        }
+    }
+};
+
+template <class T, class Allocator>
+void swap(column_buffer<T, Allocator>& left,
+          column_buffer<T, Allocator>& right)
+    noexcept(noexcept(left.swap(right)))
+{
+    left.swap(right);
+}
+
+// A buffer of strings of a column: the i-th value is [data() + offsets()[i],
+// data() + offsets()[i + 1]) and the validity bitmap is that of
+// column_buffer; only when Ch is char, whose offsets count bytes, is this
+// the layout of Apache Arrow's variable-size binary arrays
+template <class Ch, class Tr = std::char_traits<Ch>,
+          class Allocator = std::allocator<Ch>>
+class basic_string_column_buffer
+{
+public:
+    using offset_type = std::int32_t;
+
+private:
+    using offsets_a_t = typename std::allocator_traits<Allocator>::
+        template rebind_alloc<offset_type>;
+
+    std::vector<Ch, Allocator> data_;
+    std::vector<offset_type, offsets_a_t> offsets_;
+        // empty or one longer than the values
+    detail::column::validity_bitmap<Allocator> validity_;
+
+    static constexpr offset_type zero_offset = 0;
+
+public:
+    using value_type = std::basic_string_view<Ch, Tr>;
+    using char_type = Ch;
+    using traits_type = Tr;
+    using allocator_type = Allocator;
+    using size_type = typename std::vector<Ch, Allocator>::size_type;
+
+    static constexpr size_type min_bulk_capacity =
+        detail::column::min_bulk_capacity;
+
+    basic_string_column_buffer()
+        noexcept(std::is_nothrow_default_constructible_v<Allocator>) :
+        basic_string_column_buffer(Allocator())
+    {}
+
+    explicit basic_string_column_buffer(const Allocator& alloc) noexcept :
+        data_(alloc), offsets_(offsets_a_t(alloc)), validity_(alloc)
+    {}
+
+    basic_string_column_buffer(const basic_string_column_buffer&) = default;
+    basic_string_column_buffer(basic_string_column_buffer&&) = default;
+    ~basic_string_column_buffer() = default;
+    basic_string_column_buffer& operator=(
+        const basic_string_column_buffer&) = default;
+    basic_string_column_buffer& operator=(
+        basic_string_column_buffer&&) = default;
+
+    allocator_type get_allocator() const noexcept
+    {
+        return data_.get_allocator();
+    }
+
+    size_type size() const noexcept
+    {
+        return offsets_.empty() ? 0 : (offsets_.size() - 1);
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    size_type capacity() const noexcept
+    {
+        return offsets_.empty() ? 0 : (offsets_.capacity() - 1);
+    }
+
+    void reserve(size_type n, size_type data_n = 0)
+    {
+        offsets_.reserve(n + 1);                                // throw
+        validity_.reserve(n);                                   // throw
+        data_.reserve(data_n);                                  // throw
+    }
+
+    // Returns size() + 1 offsets
+    const offset_type* offsets() const noexcept
+    {
+        return offsets_.empty() ? &zero_offset : offsets_.data();
+    }
+
+    const Ch* data() const noexcept
+    {
+        return data_.data();
+    }
+
+    size_type data_size() const noexcept
+    {
+        return data_.size();
+    }
+
+    value_type operator[](size_type i) const noexcept
+    {
+        assert(i < size());
+        return value_type(data_.data() + offsets_[i],
+                          offsets_[i + 1] - offsets_[i]);
+    }
+
+    // Returns a null pointer when there are no nulls
+    const std::uint8_t* validity_bitmap() const noexcept
+    {
+        return validity_.data();
+    }
+
+    bool is_valid(size_type i) const noexcept
+    {
+        assert(i < size());
+        return validity_.is_valid(i);
+    }
+
+    size_type null_count() const noexcept
+    {
+        return validity_.null_count();
+    }
+
+    void push_back(value_type value)
+    {
+        using limits_t = std::numeric_limits<offset_type>;
+        if (value.size() > static_cast<std::size_t>(
+                limits_t::max() - static_cast<offset_type>(data_.size()))) {
+            throw std::length_error(
+                "Total length of strings exceeds the offset limit");
+        }
+        grow();                                                 // throw
+        validity_.push_valid(size());                           // throw
+        data_.insert(data_.end(), value.cbegin(), value.cend());// throw
+        offsets_.push_back(static_cast<offset_type>(data_.size()));
+    }
+
+    void push_null()
+    {
+        grow();                                                 // throw
+        validity_.push_null(size(), capacity());                // throw
+        offsets_.push_back(offsets_.back());
+    }
+
+    void clear() noexcept
+    {
+        data_.clear();
+        offsets_.clear();
+        validity_.clear();
+    }
+
+    void swap(basic_string_column_buffer& other)
+        noexcept(std::allocator_traits<Allocator>::
+                    propagate_on_container_swap::value
+              || std::allocator_traits<Allocator>::is_always_equal::value)
+    {
+        data_.swap(other.data_);
+        offsets_.swap(other.offsets_);
+        validity_.swap(other.validity_);
+    }
+
+private:
+    void grow()
+    {
+        if (offsets_.empty()) {
+            offsets_.reserve(min_bulk_capacity + 1);            // throw
+            offsets_.push_back(0);
+        } else if (offsets_.size() == offsets_.capacity()) {
+            reserve(detail::column::next_capacity(capacity())); // throw
+        }
+    }
+};
+
+template <class Ch, class Tr, class Allocator>
+void swap(basic_string_column_buffer<Ch, Tr, Allocator>& left,
+          basic_string_column_buffer<Ch, Tr, Allocator>& right)
+    noexcept(noexcept(left.swap(right)))
+{
+    left.swap(right);
+}
+
+using string_column_buffer = basic_string_column_buffer<char>;
+using wstring_column_buffer = basic_string_column_buffer<wchar_t>;
+
+namespace detail::column {
+
+// Wraps a field translator whose sink appends to a column buffer and pushes
+// a null whenever the translator puts nothing, so that the column buffer has
+// exactly one element for each record
+template <class FieldTranslator, class Column>
+class populator
+{
+    FieldTranslator translator_;
+    Column* values_;
+
+public:
+    using value_type = typename Column::value_type;
+
+    template <class FieldTranslatorR>
+    populator(FieldTranslatorR&& translator, Column& values) :
+        translator_(std::forward<FieldTranslatorR>(translator)),
+        values_(std::addressof(values))
+    {}
+
+    decltype(auto) get_skipping_handler() const noexcept
+    {
+        return translator_.get_skipping_handler();
+    }
+
+    decltype(auto) get_skipping_handler() noexcept
+    {
+        return translator_.get_skipping_handler();
+    }
+
+    decltype(auto) get_conversion_error_handler() const noexcept
+    {
+        return translator_.get_conversion_error_handler();
+    }
+
+    decltype(auto) get_conversion_error_handler() noexcept
+    {
+        return translator_.get_conversion_error_handler();
+    }
+
+    template <class... Args>
+    auto operator()(Args&&... args)
+     -> decltype(std::declval<FieldTranslator&>()(std::forward<Args>(args)...),
+                 void())
+    {
+        const auto n = values_->size();
+        translator_(std::forward<Args>(args)...);               // throw
+        if (values_->size() == n) {
+            values_->push_null();                               // throw
+        }
+    }
+};
+
+template <class Column>
+class sink
+{
+    Column* values_;
+
+public:
+    explicit sink(Column& values) noexcept :
+        values_(std::addressof(values))
+    {}
+
+    void operator()(typename Column::value_type value)
+    {
+        values_->push_back(value);                              // throw
+    }
+};
+
+template <class Column>
+struct is_arrow_layout : std::true_type
+{};
+
+template <class Ch, class Tr, class Allocator>
+struct is_arrow_layout<basic_string_column_buffer<Ch, Tr, Allocator>> :
+    std::is_same<Ch, char>
+{};
+
+template <class Column, class... Appendices>
+struct populator_of
+{
+    using type = populator<
+        decltype(scanner::make_field_translator_na<
+                typename Column::value_type>(
+            std::declval<sink<Column>>(), std::declval<Appendices>()...)),
+        Column>;
+};
+
+template <class Column, class... Appendices>
+auto make_populator(Column& values, Appendices&&... appendices)
+{
+    using ret_t = typename populator_of<Column, Appendices...>::type;
+    return ret_t(
+        make_field_translator<typename Column::value_type>(
+            sink<Column>(values), std::forward<Appendices>(appendices)...),
+        values);
+}
+
+} // end detail::column
+
+template <class T, class Allocator, class... Appendices>
+[[nodiscard]]
+auto make_field_translator(column_buffer<T, Allocator>& values,
+    Appendices&&... appendices)
+ -> std::enable_if_t<
+        is_default_translatable_arithmetic_type_v<T>,
+        typename detail::column::
+            populator_of<column_buffer<T, Allocator>, Appendices...>::type>
+{
+    return detail::column::make_populator(values,
+        std::forward<Appendices>(appendices)...);
+}
+
+template <class Ch, class Tr, class Allocator, class... Appendices>
+[[nodiscard]]
+auto make_field_translator(
+    basic_string_column_buffer<Ch, Tr, Allocator>& values,
+    Appendices&&... appendices)
+ -> typename detail::column::populator_of<
+        basic_string_column_buffer<Ch, Tr, Allocator>, Appendices...>::type
+{
+    return detail::column::make_populator(values,
+        std::forward<Appendices>(appendices)...);
+}
+
+// A record-end scanner which hands column buffers to a batch handler every
+// time the specified number of records have been scanned, and clears them
+// afterwards; flush() shall be called after parsing to hand the rest, and
+// a zero batch size means that only flush() hands them; string columns
+// shall be of char so that the batches are in the layout of Apache Arrow
+template <class BatchHandler, class... Columns>
+class record_batch_emitter :
+    detail::member_like_base<BatchHandler>
+{
+    static_assert(sizeof...(Columns) > 0);
+    static_assert((detail::column::is_arrow_layout<Columns>::value && ...),
+        "String columns to be emitted shall be of char");
+
+    std::size_t batch_size_;
+    std::size_t record_count_;
+    std::tuple<Columns*...> columns_;
+
+public:
+    using batch_handler_type = BatchHandler;
+
+    template <class BatchHandlerR>
+    record_batch_emitter(std::size_t batch_size,
+        BatchHandlerR&& handle_batch, Columns&... columns) :
+        detail::member_like_base<BatchHandler>(
+            std::forward<BatchHandlerR>(handle_batch)),
+        batch_size_(batch_size), record_count_(0),
+        columns_(std::addressof(columns)...)
+    {}
+
+    const BatchHandler& get_batch_handler() const noexcept
+    {
+        return this->get();
+    }
+
+    BatchHandler& get_batch_handler() noexcept
+    {
+        return this->get();
+    }
+
+    std::size_t batch_size() const noexcept
+    {
+        return batch_size_;
+    }
+
+    // The number of records not handed yet
+    std::size_t record_count() const noexcept
+    {
+        return record_count_;
+    }
+
+    void operator()()
+    {
+        ++record_count_;
+        if (record_count_ == batch_size_) {
+            flush();                                            // throw
+        }
+    }
+
+    void flush()
+    {
+        if (record_count_ == 0) {
+            return;
+        }
+        std::apply([this](auto*... columns) {
+            assert(((columns->size() == record_count_) && ...));
+            // The handler may move the buffers out, so they are cleared
+            // only afterwards
+            this->get()(record_count_, *columns...);            // throw
+            (columns->clear(), ...);
+        }, columns_);
+        record_count_ = 0;
+    }
+};
+
+template <class BatchHandler, class... Columns>
+[[nodiscard]] auto make_record_batch_emitter(std::size_t batch_size,
+    BatchHandler&& handle_batch, Columns&... columns)
+{
+    return record_batch_emitter<std::decay_t<BatchHandler>, Columns...>(
+        batch_size, std::forward<BatchHandler>(handle_batch), columns...);
+}
+
+}
+
+#endif
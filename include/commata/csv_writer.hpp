@@ -0,0 +1,326 @@
+/**
+ * These codes are licensed under the Unlicense.
+ * http://unlicense.org
+ */
+
+#ifndef COMMATA_GUARD_E12F20AB_02BC_4FFF_8AE8_95DD662FC6EF
+#define COMMATA_GUARD_E12F20AB_02BC_4FFF_8AE8_95DD662FC6EF
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <ios>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "detail/key_chars.hpp"
+
+namespace commata {
+
+enum class csv_quoting : std::uint_fast8_t
+{
+    minimal, all
+};
+
+enum class csv_line_terminator : std::uint_fast8_t
+{
+    lf, crlf
+};
+
+namespace detail::csv_writing {
+
+// Tells whether [first, last) has any of comma, double quote, CR and LF;
+// each block is scanned without branches so that the compilers can
+// vectorize the scanning
+template <class Ch>
+bool needs_quotation(const Ch* first, const Ch* last) noexcept
+{
+    constexpr std::ptrdiff_t block = 64;
+    while (first != last) {
+        const Ch* const block_last = first + std::min(last - first, block);
+        bool found = false;
+        for (; first != block_last; ++first) {
+            const Ch c = *first;
+            found |= (c == key_chars<Ch>::comma_c)
+                   | (c == key_chars<Ch>::dquote_c)
+                   | (c == key_chars<Ch>::cr_c)
+                   | (c == key_chars<Ch>::lf_c);
+        }
+        if (found) {
+            return true;
+        }
+    }
+    return false;
+}
+
+template <class T, class Ch>
+constexpr bool is_number_v =
+    std::is_arithmetic_v<T>
+ && !std::is_same_v<T, bool> && !std::is_same_v<T, char>
+ && !std::is_same_v<T, Ch>;
+
+// Writes value to s, which shall have at least 64 elements, and returns the
+// end of the written chars; floating-point numbers are written in the
+// shortest form that is read back to the same value
+template <class T>
+char* to_chars(char* s, T value) noexcept
+{
+    constexpr std::size_t n = 64;
+#ifndef __cpp_lib_to_chars
+    if constexpr (std::is_floating_point_v<T>) {
+        const int r = std::snprintf(s, n, "%.*Lg",
+            std::numeric_limits<T>::max_digits10,
+            static_cast<long double>(value));
+        return s + r;
+    } else
+#endif
+    {
+        return std::to_chars(s, s + n, value).ptr;
+    }
+}
+
+} // end detail::csv_writing
+
+template <class Ch, class Tr = std::char_traits<Ch>,
+          class Allocator = std::allocator<Ch>>
+class csv_writer
+{
+public:
+    using char_type = Ch;
+    using traits_type = Tr;
+    using allocator_type = Allocator;
+
+    static constexpr std::size_t default_buffer_size = 65536;
+
+private:
+    std::basic_streambuf<Ch, Tr>* out_;
+    std::vector<Ch, Allocator> buffer_;
+    std::size_t length_;        // of the chars in buffer_ not written yet
+    csv_quoting quoting_;
+    csv_line_terminator terminator_;
+    bool record_started_;
+
+public:
+    explicit csv_writer(std::basic_streambuf<Ch, Tr>& out,
+        csv_quoting quoting = csv_quoting::minimal,
+        csv_line_terminator terminator = csv_line_terminator::lf,
+        std::size_t buffer_size = 0) :
+        csv_writer(std::allocator_arg, Allocator(), out,
+            quoting, terminator, buffer_size)
+    {}
+
+    csv_writer(std::allocator_arg_t, const Allocator& alloc,
+        std::basic_streambuf<Ch, Tr>& out,
+        csv_quoting quoting = csv_quoting::minimal,
+        csv_line_terminator terminator = csv_line_terminator::lf,
+        std::size_t buffer_size = 0) :
+        out_(std::addressof(out)),
+        buffer_(((buffer_size > 0) ? buffer_size : default_buffer_size),
+                Ch(), alloc),                                       // throw
+        length_(0), quoting_(quoting), terminator_(terminator),
+        record_started_(false)
+    {}
+
+    csv_writer(csv_writer&& other) noexcept :
+        out_(std::exchange(other.out_, nullptr)),
+        buffer_(std::move(other.buffer_)),
+        length_(std::exchange(other.length_, 0)),
+        quoting_(other.quoting_), terminator_(other.terminator_),
+        record_started_(other.record_started_)
+    {}
+
+    // Flushes the buffer, swallowing the failure as std::basic_filebuf's
+    // destructor does
+    ~csv_writer()
+    {
+        try {
+            flush();
+        } catch (...) {
+        }
+    }
+
+    allocator_type get_allocator() const noexcept
+    {
+        return buffer_.get_allocator();
+    }
+
+    template <class T>
+    csv_writer& field(const T& value)
+    {
+        const bool first_field = !record_started_;
+        start_field();                                              // throw
+        if constexpr (std::is_convertible_v<const T&,
+                                        std::basic_string_view<Ch, Tr>>) {
+            const std::basic_string_view<Ch, Tr> v = value;
+            put_string(v.data(), v.data() + v.size(), first_field); // throw
+        } else {
+            static_assert(detail::csv_writing::is_number_v<T, Ch>,
+                "Fields shall be strings or arithmetic types except bool "
+                "and char types");
+            put_number(value);                                      // throw
+        }
+        return *this;
+    }
+
+    template <class FieldRange>
+    csv_writer& fields(const FieldRange& values)
+    {
+        using std::begin;
+        using std::end;
+        for (auto i = begin(values), ie = end(values); i != ie; ++i) {
+            field(*i);                                              // throw
+        }
+        return *this;
+    }
+
+    csv_writer& end_record()
+    {
+        if (terminator_ == csv_line_terminator::crlf) {
+            put_char(detail::key_chars<Ch>::cr_c);                  // throw
+        }
+        put_char(detail::key_chars<Ch>::lf_c);                      // throw
+        record_started_ = false;
+        return *this;
+    }
+
+    template <class... Fields>
+    csv_writer& record(const Fields&... values)
+    {
+        (field(values), ...);                                       // throw
+        return end_record();                                        // throw
+    }
+
+    // Writes each element of [first, last) as a record, each of which shall
+    // be a range of fields
+    template <class InputIterator>
+    csv_writer& records(InputIterator first, InputIterator last)
+    {
+        for (; first != last; ++first) {
+            fields(*first);                                         // throw
+            end_record();                                           // throw
+        }
+        return *this;
+    }
+
+    // Writes the buffered chars to the stream buffer
+    void flush()
+    {
+        if (out_ && (length_ > 0)) {
+            const auto n = std::exchange(length_, 0);
+            write_out(buffer_.data(), n);                           // throw
+        }
+    }
+
+private:
+    void start_field()
+    {
+        if (record_started_) {
+            put_char(detail::key_chars<Ch>::comma_c);               // throw
+        } else {
+            record_started_ = true;
+        }
+    }
+
+    void put_string(const Ch* first, const Ch* last, bool first_field)
+    {
+        // An empty first field is quoted lest a record with only it should
+        // be written as an empty line, which parsers skip
+        if ((quoting_ == csv_quoting::all)
+         || (first_field && (first == last))
+         || detail::csv_writing::needs_quotation(first, last)) {
+            put_char(detail::key_chars<Ch>::dquote_c);              // throw
+            // Runs between double quotes are put in one go
+            for (;;) {
+                const Ch* const q = Tr::find(
+                    first, last - first, detail::key_chars<Ch>::dquote_c);
+                if (!q) {
+                    put(first, last);                               // throw
+                    break;
+                }
+                put(first, q + 1);                                  // throw
+                put_char(detail::key_chars<Ch>::dquote_c);          // throw
+                first = q + 1;
+            }
+            put_char(detail::key_chars<Ch>::dquote_c);              // throw
+        } else {
+            put(first, last);                                       // throw
+        }
+    }
+
+    template <class T>
+    void put_number(T value)
+    {
+        char s[64];
+        char* const e = detail::csv_writing::to_chars(s, value);
+        if (quoting_ == csv_quoting::all) {
+            put_char(detail::key_chars<Ch>::dquote_c);              // throw
+        }
+        if constexpr (std::is_same_v<Ch, char>) {
+            put(s, e);                                              // throw
+        } else {
+            // Numbers consist of the chars in the basic character set
+            Ch t[64];
+            std::transform(s, e, t, [](char c) {
+                return static_cast<Ch>(c);
+            });
+            put(t, t + (e - s));                                    // throw
+        }
+        if (quoting_ == csv_quoting::all) {
+            put_char(detail::key_chars<Ch>::dquote_c);              // throw
+        }
+    }
+
+    void put_char(Ch c)
+    {
+        if (length_ == buffer_.size()) {
+            flush();                                                // throw
+        }
+        buffer_[length_++] = c;
+    }
+
+    // Long runs bypass the buffer
+    void put(const Ch* first, const Ch* last)
+    {
+        const auto n = static_cast<std::size_t>(last - first);
+        if (n > buffer_.size() - length_) {
+            flush();                                                // throw
+            if (n >= buffer_.size()) {
+                write_out(first, n);                                // throw
+                return;
+            }
+        }
+        Tr::copy(buffer_.data() + length_, first, n);
+        length_ += n;
+    }
+
+    void write_out(const Ch* s, std::size_t n)
+    {
+        if (static_cast<std::size_t>(out_->sputn(
+                s, static_cast<std::streamsize>(n))) != n) {        // throw
+            throw std::ios_base::failure(
+                "Failed to write to the stream buffer");
+        }
+    }
+};
+
+template <class Ch, class Tr, class... Args>
+csv_writer(std::basic_streambuf<Ch, Tr>&, Args...)
+ -> csv_writer<Ch, Tr, std::allocator<Ch>>;
+
+template <class Allocator, class Ch, class Tr, class... Args>
+csv_writer(std::allocator_arg_t, Allocator, std::basic_streambuf<Ch, Tr>&,
+    Args...)
+ -> csv_writer<Ch, Tr, Allocator>;
+
+}
+
+#endif
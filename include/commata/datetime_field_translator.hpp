@@ -0,0 +1,546 @@
+/**
+ * These codes are licensed under the Unlicense.
+ * http://unlicense.org
+ */
+
+#ifndef COMMATA_GUARD_2F5551D3_DA97_47C7_BAFE_3B1E7863DD63
+#define COMMATA_GUARD_2F5551D3_DA97_47C7_BAFE_3B1E7863DD63
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <ratio>
+#include <type_traits>
+#include <utility>
+
+#include "field_scanners.hpp"
+#include "text_value_translation.hpp"
+#include "detail/member_like_base.hpp"
+
+namespace commata {
+
+namespace datetime_format {
+
+// "YYYY-MM-DD" or "YYYY-MM-DDThh:mm:ss[.f...]" optionally followed by "Z"
+// or a UTC offset "+hh:mm", "+hhmm", "-hh:mm" or "-hhmm"
+struct iso8601 {};
+
+// "YYYY-MM-DD hh:mm:ss[.f...]" in UTC
+struct ymd_hms {};
+
+// Signed integral seconds since 1970-01-01T00:00:00Z
+struct epoch_seconds {};
+
+// Signed integral milliseconds since 1970-01-01T00:00:00Z
+struct epoch_milliseconds {};
+
+} // end datetime_format
+
+namespace detail::datetime {
+
+template <class T>
+constexpr bool is_format_v =
+    std::is_same_v<T, datetime_format::iso8601>
+ || std::is_same_v<T, datetime_format::ymd_hms>
+ || std::is_same_v<T, datetime_format::epoch_seconds>
+ || std::is_same_v<T, datetime_format::epoch_milliseconds>;
+
+template <class T>
+constexpr bool is_sys_time_v = false;
+
+template <class Duration>
+constexpr bool is_sys_time_v<
+    std::chrono::time_point<std::chrono::system_clock, Duration>> = true;
+
+enum class parse_result
+{
+    ok,
+    invalid_format,
+    above_upper_limit,
+    below_lower_limit
+};
+
+// A point of time in UTC, whose nanoseconds is in [0, 1000000000)
+struct instant
+{
+    std::int64_t seconds;
+    std::int32_t nanoseconds;
+};
+
+template <class Ch>
+constexpr unsigned digit(Ch c) noexcept
+{
+    return static_cast<unsigned>(c) - static_cast<unsigned>('0');
+}
+
+template <class Ch>
+constexpr bool is_space(Ch c) noexcept
+{
+    return (c == Ch(' ')) || (c == Ch('\t'));
+}
+
+// Reads N decimal digits; a non-digit is not branched on but recorded in bad
+// so that a fixed layout is validated with a single branch at its end
+template <unsigned N, class Ch>
+constexpr unsigned fixed_digits(const Ch* s, unsigned& bad) noexcept
+{
+    unsigned v = 0;
+    for (unsigned i = 0; i < N; ++i) {
+        const auto d = digit(s[i]);
+        bad |= static_cast<unsigned>(d > 9);
+        v = v * 10 + d;
+    }
+    return v;
+}
+
+// Returns the number of days since 1970-01-01 in the proleptic Gregorian
+// calendar (Howard Hinnant's days_from_civil)
+constexpr std::int64_t days_from_civil(
+    std::int64_t y, unsigned m, unsigned d) noexcept
+{
+    y -= (m <= 2) ? 1 : 0;
+    const std::int64_t era = ((y >= 0) ? y : (y - 399)) / 400;
+    const auto yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153 * ((m > 2) ? (m - 3) : (m + 9)) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<std::int64_t>(doe) - 719468;
+}
+
+constexpr unsigned last_day_of_month(unsigned y, unsigned m) noexcept
+{
+    if (m == 2) {
+        return ((y % 4 == 0) && ((y % 100 != 0) || (y % 400 == 0))) ?
+            29 : 28;
+    } else {
+        return ((m == 4) || (m == 6) || (m == 9) || (m == 11)) ? 30 : 31;
+    }
+}
+
+// Parses "YYYY-MM-DD" at [begin, begin + 10)
+template <class Ch>
+bool parse_date(const Ch* begin, std::int64_t& days) noexcept
+{
+    unsigned bad = 0;
+    const auto y = fixed_digits<4>(begin, bad);
+    bad |= static_cast<unsigned>(begin[4] != Ch('-'));
+    const auto m = fixed_digits<2>(begin + 5, bad);
+    bad |= static_cast<unsigned>(begin[7] != Ch('-'));
+    const auto d = fixed_digits<2>(begin + 8, bad);
+    if ((bad != 0) || (m - 1 > 11) || (d - 1 >= last_day_of_month(y, m))) {
+        return false;
+    }
+    days = days_from_civil(y, m, d);
+    return true;
+}
+
+// Parses "hh:mm:ss" at [begin, begin + 8)
+template <class Ch>
+bool parse_time(const Ch* begin, std::int64_t& seconds) noexcept
+{
+    unsigned bad = 0;
+    const auto h = fixed_digits<2>(begin, bad);
+    bad |= static_cast<unsigned>(begin[2] != Ch(':'));
+    const auto m = fixed_digits<2>(begin + 3, bad);
+    bad |= static_cast<unsigned>(begin[5] != Ch(':'));
+    const auto s = fixed_digits<2>(begin + 6, bad);
+    if ((bad != 0) || (h > 23) || (m > 59) || (s > 59)) {
+        return false;
+    }
+    seconds = h * 3600 + m * 60 + s;
+    return true;
+}
+
+// Parses an optional fraction of a second such as ".25"; digits below
+// nanoseconds are truncated
+template <class Ch>
+bool parse_fraction(const Ch*& begin, const Ch* end,
+    std::int32_t& nanoseconds) noexcept
+{
+    nanoseconds = 0;
+    if ((begin == end) || ((*begin != Ch('.')) && (*begin != Ch(',')))) {
+        return true;
+    }
+    ++begin;
+    const auto digits_begin = begin;
+    std::int32_t scale = 100000000;
+    for (; (begin != end) && (digit(*begin) <= 9); ++begin) {
+        nanoseconds += static_cast<std::int32_t>(digit(*begin)) * scale;
+        scale /= 10;
+    }
+    return begin != digits_begin;
+}
+
+// Parses a UTC designator of ISO 8601 into the offset in seconds
+template <class Ch>
+bool parse_utc_offset(const Ch* begin, const Ch* end,
+    std::int64_t& offset) noexcept
+{
+    offset = 0;
+    if (begin == end) {
+        return true;
+    } else if ((*begin == Ch('Z')) || (*begin == Ch('z'))) {
+        return end - begin == 1;
+    } else if ((*begin != Ch('+')) && (*begin != Ch('-'))) {
+        return false;
+    }
+
+    const bool has_colon = (end - begin == 6);
+    if (!has_colon && (end - begin != 5)) {
+        return false;
+    }
+    unsigned bad = 0;
+    const auto h = fixed_digits<2>(begin + 1, bad);
+    if (has_colon) {
+        bad |= static_cast<unsigned>(begin[3] != Ch(':'));
+    }
+    const auto m = fixed_digits<2>(begin + (has_colon ? 4 : 3), bad);
+    if ((bad != 0) || (h > 23) || (m > 59)) {
+        return false;
+    }
+    offset = h * 3600 + m * 60;
+    if (*begin == Ch('-')) {
+        offset = -offset;
+    }
+    return true;
+}
+
+template <class Ch>
+parse_result parse(datetime_format::ymd_hms,
+    const Ch* begin, const Ch* end, instant& r) noexcept
+{
+    std::int64_t days;
+    std::int64_t seconds;
+    if ((end - begin < 19)
+     || (begin[10] != Ch(' '))
+     || !parse_date(begin, days)
+     || !parse_time(begin + 11, seconds)) {
+        return parse_result::invalid_format;
+    }
+    begin += 19;
+    if (!parse_fraction(begin, end, r.nanoseconds) || (begin != end)) {
+        return parse_result::invalid_format;
+    }
+    r.seconds = days * 86400 + seconds;
+    return parse_result::ok;
+}
+
+template <class Ch>
+parse_result parse(datetime_format::iso8601,
+    const Ch* begin, const Ch* end, instant& r) noexcept
+{
+    std::int64_t days;
+    if ((end - begin < 10) || !parse_date(begin, days)) {
+        return parse_result::invalid_format;
+    }
+    if (end - begin == 10) {
+        r.seconds = days * 86400;
+        r.nanoseconds = 0;
+        return parse_result::ok;
+    }
+
+    std::int64_t seconds;
+    std::int64_t offset;
+    if ((end - begin < 19)
+     || ((begin[10] != Ch('T')) && (begin[10] != Ch('t')))
+     || !parse_time(begin + 11, seconds)) {
+        return parse_result::invalid_format;
+    }
+    begin += 19;
+    if (!parse_fraction(begin, end, r.nanoseconds)
+     || !parse_utc_offset(begin, end, offset)) {
+        return parse_result::invalid_format;
+    }
+    r.seconds = days * 86400 + seconds - offset;
+    return parse_result::ok;
+}
+
+// Parses a signed integer of at most 18 digits, which never overflows
+// std::int64_t
+template <class Ch>
+parse_result parse_epoch(const Ch* begin, const Ch* end, std::int64_t& r)
+    noexcept
+{
+    bool negative = false;
+    if (*begin == Ch('-')) {
+        negative = true;
+        ++begin;
+    } else if (*begin == Ch('+')) {
+        ++begin;
+    }
+    if (begin == end) {
+        return parse_result::invalid_format;
+    }
+
+    std::int64_t v = 0;
+    for (auto i = begin; i != end; ++i) {
+        const auto d = digit(*i);
+        if (d > 9) {
+            return parse_result::invalid_format;
+        }
+        if (i - begin == 18) {
+            // Too many digits, but they could be followed by a non-digit
+            if (std::find_if(i, end, [](Ch c) { return digit(c) > 9; })
+                    != end) {
+                return parse_result::invalid_format;
+            }
+            return negative ? parse_result::below_lower_limit :
+                              parse_result::above_upper_limit;
+        }
+        v = v * 10 + d;
+    }
+    r = negative ? -v : v;
+    return parse_result::ok;
+}
+
+template <class Ch>
+parse_result parse(datetime_format::epoch_seconds,
+    const Ch* begin, const Ch* end, instant& r) noexcept
+{
+    const auto result = parse_epoch(begin, end, r.seconds);
+    r.nanoseconds = 0;
+    return result;
+}
+
+template <class Ch>
+parse_result parse(datetime_format::epoch_milliseconds,
+    const Ch* begin, const Ch* end, instant& r) noexcept
+{
+    std::int64_t v;
+    const auto result = parse_epoch(begin, end, v);
+    if (result == parse_result::ok) {
+        // Floored division so that the nanoseconds are not negative
+        r.seconds = v / 1000 - ((v % 1000 < 0) ? 1 : 0);
+        r.nanoseconds = static_cast<std::int32_t>(
+            (v - r.seconds * 1000) * 1000000);
+    }
+    return result;
+}
+
+template <class Duration>
+parse_result to_duration(const instant& t, Duration& r) noexcept
+{
+    using period_t = typename Duration::period;
+    using rep_t = typename Duration::rep;
+
+    // The seconds and the nanoseconds are scaled separately so that the
+    // count is exact in long double with a 64-bit significand, which is the
+    // case for std::chrono::nanoseconds and the like
+    const long double v =
+        static_cast<long double>(t.seconds) * period_t::den / period_t::num
+      + static_cast<long double>(t.nanoseconds) * period_t::den
+            / period_t::num / 1e9L;
+    if (v > static_cast<long double>(std::numeric_limits<rep_t>::max())) {
+        return parse_result::above_upper_limit;
+    } else if (v < static_cast<long double>(
+                    std::numeric_limits<rep_t>::lowest())) {
+        return parse_result::below_lower_limit;
+    }
+
+    using std::chrono::floor;
+    using std::chrono::seconds;
+    using std::chrono::nanoseconds;
+    if constexpr (std::ratio_less_v<period_t, std::ratio<1>>) {
+        if (t.seconds < 0) {
+            // Borrows a second not to go below the lower limit on the way
+            r = floor<Duration>(seconds(t.seconds + 1))
+              + floor<Duration>(nanoseconds(t.nanoseconds - 1000000000));
+            return parse_result::ok;
+        }
+    }
+    r = floor<Duration>(seconds(t.seconds))
+      + floor<Duration>(nanoseconds(t.nanoseconds));
+    return parse_result::ok;
+}
+
+template <class T, class Format, class Ch, class H>
+std::optional<T> convert(const Ch* begin, const Ch* end, H h)
+{
+    // Surrounding spaces are allowed as arithmetic values do
+    const auto b = std::find_if(begin, end,
+        [](Ch c) { return !is_space(c); });
+    auto e = end;
+    while ((e != b) && is_space(*(e - 1))) {
+        --e;
+    }
+    if (b == e) {
+        return h(empty_t());
+    }
+
+    instant t;
+    auto result = parse(Format(), b, e, t);
+    typename T::duration d;
+    if (result == parse_result::ok) {
+        result = to_duration(t, d);
+    }
+    switch (result) {
+    case parse_result::ok:
+        return T(d);
+    case parse_result::invalid_format:
+        return h(invalid_format_t(), begin, end);
+    case parse_result::above_upper_limit:
+        return h(out_of_range_t(), begin, end, 1);
+    default:
+        return h(out_of_range_t(), begin, end, -1);
+    }
+}
+
+} // end detail::datetime
+
+// A body field scanner which translates field values in the textual format
+// Format into std::chrono::time_point objects of std::chrono::system_clock
+template <class T, class Format, class Sink,
+    class SkippingHandler = fail_if_skipped,
+    class ConversionErrorHandler = fail_if_conversion_failed>
+class datetime_field_translator
+{
+    static_assert(detail::datetime::is_sys_time_v<T>);
+    static_assert(detail::datetime::is_format_v<Format>);
+
+    using translator_t = detail::scanner::translator<T, Sink, SkippingHandler>;
+
+    detail::base_member_pair<ConversionErrorHandler, translator_t> ct_;
+
+public:
+    using value_type = T;
+    using format_type = Format;
+    using skipping_handler_type = SkippingHandler;
+    using conversion_error_handler_type = ConversionErrorHandler;
+
+    template <class SinkR, class SkippingHandlerR = SkippingHandler,
+              class ConversionErrorHandlerR = ConversionErrorHandler,
+              std::enable_if_t<
+                !std::is_base_of_v<
+                    datetime_field_translator, std::decay_t<SinkR>>>*
+                        = nullptr>
+    explicit datetime_field_translator(
+        SinkR&& sink,
+        SkippingHandlerR&& handle_skipping =
+            std::decay_t<SkippingHandlerR>(),
+        ConversionErrorHandlerR&& handle_conversion_error =
+            std::decay_t<ConversionErrorHandlerR>()) :
+        ct_(std::forward<ConversionErrorHandlerR>(handle_conversion_error),
+            translator_t(std::forward<SinkR>(sink),
+                         std::forward<SkippingHandlerR>(handle_skipping)))
+    {}
+
+    datetime_field_translator(const datetime_field_translator&) = default;
+    datetime_field_translator(datetime_field_translator&&) = default;
+    ~datetime_field_translator() = default;
+
+    const SkippingHandler& get_skipping_handler() const noexcept
+    {
+        return ct_.member().get_skipping_handler();
+    }
+
+    SkippingHandler& get_skipping_handler() noexcept
+    {
+        return ct_.member().get_skipping_handler();
+    }
+
+    ConversionErrorHandler& get_conversion_error_handler() noexcept
+    {
+        return ct_.base();
+    }
+
+    const ConversionErrorHandler& get_conversion_error_handler() const noexcept
+    {
+        return ct_.base();
+    }
+
+    void operator()()
+    {
+        ct_.member().field_skipped();
+    }
+
+    template <class Ch>
+    auto operator()(const Ch* begin, const Ch* end)
+     -> std::enable_if_t<std::is_same_v<Ch, char>
+                      || std::is_same_v<Ch, wchar_t>>
+    {
+        auto converted = detail::datetime::convert<T, Format>(begin, end,
+            detail::xlate::error_handler<T, ConversionErrorHandler&>(
+                ct_.base()));
+        if (converted) {
+            ct_.member().put(*converted);
+        }
+    }
+};
+
+namespace detail::datetime {
+
+template <class T, class Format, class Sink, class... As>
+struct translator_of;
+
+template <class T, class Format, class Sink>
+struct translator_of<T, Format, Sink>
+{
+    using type = datetime_field_translator<T, Format, Sink>;
+};
+
+template <class T, class Format, class Sink, class S>
+struct translator_of<T, Format, Sink, S>
+{
+    using type = datetime_field_translator<T, Format, Sink,
+        scanner::skipping_handler_t<T, S>>;
+};
+
+template <class T, class Format, class Sink, class S, class C>
+struct translator_of<T, Format, Sink, S, C>
+{
+    using type = datetime_field_translator<T, Format, Sink,
+        scanner::skipping_handler_t<T, S>,
+        scanner::conversion_error_handler_t<T, C>>;
+};
+
+template <class Container, class Format, class... Appendices>
+struct inserter_of
+{
+    using type = typename translator_of<
+        typename Container::value_type, Format,
+        typename scanner::any_insert_iterator<Container>::type,
+        Appendices...>::type;
+};
+
+} // end detail::datetime
+
+template <class T, class Format = datetime_format::iso8601,
+          class Sink, class... Appendices>
+[[nodiscard]]
+auto make_datetime_field_translator(Sink&& sink, Appendices&&... appendices)
+ -> std::enable_if_t<
+        detail::datetime::is_sys_time_v<T>
+     && detail::datetime::is_format_v<Format>
+     && (detail::scanner::is_output_iterator_v<std::decay_t<Sink>>
+      || std::is_invocable_v<std::decay_t<Sink>&, T>),
+        typename detail::datetime::translator_of<
+            T, Format, std::decay_t<Sink>, Appendices...>::type>
+{
+    using t = typename detail::datetime::translator_of<
+        T, Format, std::decay_t<Sink>, Appendices...>::type;
+    return t(std::forward<Sink>(sink),
+             std::forward<Appendices>(appendices)...);
+}
+
+template <class Format = datetime_format::iso8601,
+          class Container, class... Appendices>
+[[nodiscard]]
+auto make_datetime_field_translator(
+    Container& values, Appendices&&... appendices)
+ -> std::enable_if_t<
+        detail::datetime::is_format_v<Format>
+     && detail::datetime::is_sys_time_v<typename Container::value_type>
+     && detail::scanner::is_any_insertable_v<Container>,
+        typename detail::datetime::inserter_of<
+            Container, Format, Appendices...>::type>
+{
+    using t = typename detail::datetime::inserter_of<
+        Container, Format, Appendices...>::type;
+    return t(detail::scanner::any_insert_iterator<Container>::from(values),
+             std::forward<Appendices>(appendices)...);
+}
+
+}
+
+#endif
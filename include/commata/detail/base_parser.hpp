@@ -6,9 +6,12 @@
 #ifndef COMMATA_GUARD_9AF7CB02_5702_4A95_AA5E_781F44203C7F
 #define COMMATA_GUARD_9AF7CB02_5702_4A95_AA5E_781F44203C7F
 
+#include <cstddef>
+#include <string>
 #include <type_traits>
 
 #include "handler_decorator.hpp"
+#include "key_chars.hpp"
 
 namespace commata::detail {
 
@@ -223,6 +226,59 @@ public:
         return { physical_line_index_, get_physical_column_index() };
     }
 
+    // Skips at most n records that lie wholly in the rest of the current
+    // buffer by scanning only for line breaks, provided that the parser has
+    // been suspended just after an end of a record; stops at a line that
+    // needs the state machine (see D::is_plain_line) and reports no events
+    // on the skipped lines, and returns the number of the skipped records
+    std::size_t skip_plain_records(std::size_t n, bool counts_empty_lines)
+    {
+        if constexpr (has_yield_location_v<Handler>) {
+            using tr_t = std::char_traits<char_type>;
+            constexpr auto cr = key_chars<char_type>::cr_c;
+            constexpr auto lf = key_chars<char_type>::lf_c;
+
+            if ((n == 0) || (f_.yield_location() != 1)) {
+                return 0;
+            }
+            if ((s_ == D::after_cr_state)
+             && (p_ + 1 < buffer_last_) && (p_[1] == lf)) {
+                // Same as what the state machine does on LF after CR
+                ++p_;
+                s_ = D::after_lf_state;
+            }
+            if (s_ != D::after_lf_state) {
+                return 0;
+            }
+
+            std::size_t m = 0;
+            while (m < n) {
+                const auto first = p_ + 1;
+                const auto found = tr_t::find(first, buffer_last_ - first, lf);
+                if (!found) {
+                    break;
+                }
+                const auto lf_p = first + (found - first);
+                auto last = lf_p;
+                if ((last > first) && (last[-1] == cr)) {
+                    --last;
+                }
+                if (tr_t::find(first, last - first, cr)
+                 || !D::is_plain_line(first, last)) {
+                    break;
+                }
+                if ((first < last) || counts_empty_lines) {
+                    ++m;
+                }
+                p_ = lf_p;
+                new_physical_line_at(first);
+            }
+            return m;
+        } else {
+            return 0;
+        }
+    }
+
 private:
     std::size_t get_physical_column_index() const noexcept
     {
@@ -284,16 +340,24 @@ private:
 public:
     // Makes p_ become the first char of the new line
     void new_physical_line() noexcept
+    {
+        new_physical_line_at(p_);
+    }
+
+private:
+    void new_physical_line_at(buffer_char_t* p) noexcept
     {
         if (physical_line_index_ == parse_error::npos) {
             physical_line_index_ = 0;
         } else {
             ++physical_line_index_;
         }
-        physical_line_or_buffer_begin_ = p_;
+        physical_line_or_buffer_begin_ = p;
         physical_line_chars_passed_away_ = 0;
     }
 
+public:
+
     void change_state(State s) noexcept
     {
         s_ = s;
@@ -216,6 +216,16 @@ public:
                                 std::forward<Args>(args)...);
     }
 
+    const CharInput& get_input() const noexcept
+    {
+        return in_;
+    }
+
+    CharInput& get_input() noexcept
+    {
+        return in_;
+    }
+
     void swap(base_source& other)
         noexcept(std::is_nothrow_swappable_v<CharInput>)
     {
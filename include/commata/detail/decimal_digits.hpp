@@ -0,0 +1,239 @@
+/**
+ * These codes are licensed under the Unlicense.
+ * http://unlicense.org
+ */
+
+#ifndef COMMATA_GUARD_6A0F3D57_C2B8_4E19_9D46_58F1B07E2C93
+#define COMMATA_GUARD_6A0F3D57_C2B8_4E19_9D46_58F1B07E2C93
+
+#include <cfloat>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+
+namespace commata::detail::digits {
+
+// SWAR (SIMD within a register) tricks below treat eight chars loaded into
+// a std::uint64_t, so they need to know where the first char goes
+#if defined(_MSC_VER) \
+ || (defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__))
+inline constexpr bool swar_enabled = true;
+#else
+inline constexpr bool swar_enabled = false;
+#endif
+
+inline std::uint64_t load8(const char* s) noexcept
+{
+    std::uint64_t v;
+    std::memcpy(&v, s, sizeof v);
+    return v;
+}
+
+// Tells whether all of the eight chars are decimal digits
+inline bool are_all_digits8(std::uint64_t v) noexcept
+{
+    // No byte has bits above 0x3F nor has its low nibble above 9
+    return (((v & 0xF0F0F0F0F0F0F0F0U)
+           | (((v + 0x0606060606060606U) & 0xF0F0F0F0F0F0F0F0U) >> 4))
+        == 0x3333333333333333U);
+}
+
+// Parses eight decimal digits, the first of which is in the lowest byte
+inline std::uint32_t parse8(std::uint64_t v) noexcept
+{
+    v -= 0x3030303030303030U;
+    v = (v * 10) + (v >> 8);                        // pairs of two digits
+    v = ((v & 0x000000FF000000FFU) * (100 + (1000000ULL << 32))
+       + ((v >> 16) & 0x000000FF000000FFU) * (1 + (10000ULL << 32))) >> 32;
+    return static_cast<std::uint32_t>(v);
+}
+
+// Parses [begin, end), which shall consist of an optional minus sign followed
+// by at most 19 decimal digits, into r; returns false without touching r if
+// [begin, end) is not of that form or the value does not fit into T
+template <class T>
+bool parse_integer(const char* begin, const char* end, T& r) noexcept
+{
+    static_assert(std::is_integral_v<T>);
+
+    bool negative = false;
+    if constexpr (std::is_signed_v<T>) {
+        if ((begin != end) && (*begin == '-')) {
+            negative = true;
+            ++begin;
+        }
+    }
+    if ((begin == end) || (end - begin > 19)) {
+        return false;
+    }
+
+    std::uint64_t a = 0;
+    if constexpr (swar_enabled) {
+        for (; end - begin >= 8; begin += 8) {
+            const auto v = load8(begin);
+            if (!are_all_digits8(v)) {
+                return false;
+            }
+            a = a * 100000000U + parse8(v);
+        }
+    }
+    for (; begin != end; ++begin) {
+        const auto d = static_cast<unsigned char>(*begin - '0');
+        if (d > 9) {
+            return false;
+        }
+        // 19 digits never overflow std::uint64_t
+        a = a * 10 + d;
+    }
+
+    using u_t = std::make_unsigned_t<T>;
+    constexpr auto max = static_cast<u_t>(std::numeric_limits<T>::max());
+    if (negative) {
+        if (a > std::uint64_t(max) + 1) {
+            return false;
+        }
+        // Wrapping around is well-defined for unsigned integers
+        r = static_cast<T>(static_cast<u_t>(0U - static_cast<u_t>(a)));
+    } else {
+        if (a > max) {
+            return false;
+        }
+        r = static_cast<T>(a);
+    }
+    return true;
+}
+
+template <class T>
+struct exact_floating_point;
+
+template <>
+struct exact_floating_point<float>
+{
+    static constexpr std::uint64_t max_mantissa = std::uint64_t(1) << 24;
+    static constexpr float powers_of_ten[] = {
+        1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+    };
+};
+
+template <>
+struct exact_floating_point<double>
+{
+    static constexpr std::uint64_t max_mantissa = std::uint64_t(1) << 53;
+    static constexpr double powers_of_ten[] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10,
+        1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21,
+        1e22
+    };
+};
+
+// Parses [begin, end), which shall be a plain decimal floating-point number
+// such as "-123.45" or "6.02e23", into r; succeeds only when both of the
+// significand and the power of ten are exactly representable in T, in which
+// case a single multiplication or division gives the correctly rounded
+// result (Clinger's fast path), that is, the same as std::strtod and its
+// comrades give
+template <class T, class Ch>
+bool parse_floating_point(const Ch* begin, const Ch* end, T& r) noexcept
+{
+#if FLT_EVAL_METHOD == 0
+    if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>) {
+        using e_t = exact_floating_point<T>;
+        constexpr int max_exponent = static_cast<int>(
+            std::size(e_t::powers_of_ten)) - 1;
+
+        const auto digit = [](Ch c) {
+            return static_cast<unsigned>(c) - static_cast<unsigned>('0');
+        };
+
+        bool negative = false;
+        if (begin != end) {
+            if (*begin == Ch('-')) {
+                negative = true;
+                ++begin;
+            } else if (*begin == Ch('+')) {
+                ++begin;
+            }
+        }
+
+        std::uint64_t m = 0;
+        int significant_digits = 0;
+        int exponent = 0;
+        bool has_digits = false;
+        const auto accumulate = [&](unsigned d) {
+            has_digits = true;
+            if ((m == 0) && (d == 0)) {
+                return true;                // leading zeros
+            } else if (++significant_digits > 19) {
+                return false;
+            }
+            m = m * 10 + d;
+            return true;
+        };
+
+        for (; (begin != end) && (digit(*begin) <= 9); ++begin) {
+            if (!accumulate(digit(*begin))) {
+                return false;
+            }
+        }
+        if ((begin != end) && (*begin == Ch('.'))) {
+            for (++begin; (begin != end) && (digit(*begin) <= 9); ++begin) {
+                if (!accumulate(digit(*begin))) {
+                    return false;
+                }
+                --exponent;
+            }
+        }
+        if (!has_digits) {
+            return false;
+        }
+        if ((begin != end) && ((*begin == Ch('e')) || (*begin == Ch('E')))) {
+            ++begin;
+            bool negative_exponent = false;
+            if (begin != end) {
+                if (*begin == Ch('-')) {
+                    negative_exponent = true;
+                    ++begin;
+                } else if (*begin == Ch('+')) {
+                    ++begin;
+                }
+            }
+            if ((begin == end) || (digit(*begin) > 9)) {
+                return false;
+            }
+            int e = 0;
+            for (; (begin != end) && (digit(*begin) <= 9); ++begin) {
+                if (e > 9999) {
+                    return false;
+                }
+                e = e * 10 + static_cast<int>(digit(*begin));
+            }
+            exponent += negative_exponent ? -e : e;
+        }
+        if (begin != end) {
+            return false;
+        }
+
+        T v;
+        if (m == 0) {
+            v = T();
+        } else if ((m > e_t::max_mantissa)
+                || (exponent < -max_exponent)
+                || (exponent > max_exponent)) {
+            return false;
+        } else if (exponent < 0) {
+            v = static_cast<T>(m) / e_t::powers_of_ten[-exponent];
+        } else {
+            v = static_cast<T>(m) * e_t::powers_of_ten[exponent];
+        }
+        r = negative ? -v : v;
+        return true;
+    }
+#endif
+    return false;
+}
+
+}
+
+#endif
@@ -0,0 +1,59 @@
+/**
+ * These codes are licensed under the Unlicense.
+ * http://unlicense.org
+ */
+
+#ifndef COMMATA_GUARD_21F7F23F_E2F9_474A_B562_614C8EEC7728
+#define COMMATA_GUARD_21F7F23F_E2F9_474A_B562_614C8EEC7728
+
+#include <cstddef>
+#include <ios>
+#include <streambuf>
+#include <utility>
+#include <vector>
+
+namespace commata::detail {
+
+// A stream buffer which appends the chars written to it to a vector
+template <class Ch, class Tr, class Allocator>
+class vector_streambuf :
+    public std::basic_streambuf<Ch, Tr>
+{
+    std::vector<Ch, Allocator> v_;
+
+public:
+    using int_type = typename Tr::int_type;
+
+    explicit vector_streambuf(const Allocator& alloc) :
+        v_(alloc)
+    {}
+
+    void reserve(std::size_t n)
+    {
+        v_.reserve(n);                                              // throw
+    }
+
+    std::vector<Ch, Allocator> release() noexcept
+    {
+        return std::move(v_);
+    }
+
+protected:
+    std::streamsize xsputn(const Ch* s, std::streamsize n) override
+    {
+        v_.insert(v_.cend(), s, s + n);                             // throw
+        return n;
+    }
+
+    int_type overflow(int_type c) override
+    {
+        if (!Tr::eq_int_type(c, Tr::eof())) {
+            v_.push_back(Tr::to_char_type(c));                      // throw
+        }
+        return Tr::not_eof(c);
+    }
+};
+
+}
+
+#endif
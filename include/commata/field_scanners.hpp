@@ -408,6 +408,7 @@ class arithmetic_field_translator
     using translator_t = detail::scanner::translator<T, Sink, SkippingHandler>;
 
     detail::base_member_pair<ConversionErrorHandler, translator_t> ct_;
+    detail::xlate::converter<std::remove_cv_t<T>> convert_;
 
 public:
     using value_type = T;
@@ -461,13 +462,13 @@ public:
     }
 
     template <class Ch>
-    auto operator()(Ch* begin, Ch* end)
+    auto operator()(const Ch* begin, const Ch* end)
      -> std::enable_if_t<std::is_same_v<Ch, char>
                       || std::is_same_v<Ch, wchar_t>>
     {
-        *end = Ch();
-        auto converted = to_arithmetic<std::optional<T>>(
-            arithmetic_convertible<Ch>{ begin, end }, ct_.base());
+        static_assert(is_default_translatable_arithmetic_type_v<T>);
+        std::optional<T> converted = detail::xlate::do_convert<T>(
+            arithmetic_convertible<Ch>{ begin, end }, ct_.base(), convert_);
         if (converted) {
             ct_.member().put(*converted);
         }
@@ -1045,8 +1046,7 @@ struct any_insert_iterator;
 
 template <class Container>
 struct any_insert_iterator<Container,
-    std::enable_if_t<is_insertable_v<Container>
-                  && is_back_insertable_v<Container>>>
+    std::enable_if_t<is_back_insertable_v<Container>>>
 {
     using type = std::back_insert_iterator<Container>;
 
@@ -0,0 +1,325 @@
+/**
+ * These codes are licensed under the Unlicense.
+ * http://unlicense.org
+ */
+
+#ifndef COMMATA_GUARD_117E23AE_BCF0_47E3_ABCC_5785EC08AEB7
+#define COMMATA_GUARD_117E23AE_BCF0_47E3_ABCC_5785EC08AEB7
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace commata {
+
+enum class incremental_hashing : std::uint_fast8_t
+{
+    no, yes
+};
+
+namespace detail::value_set {
+
+// 64-bit FNV-1a
+constexpr std::uint64_t hash_basis = 14695981039346656037ULL;
+
+template <class Ch>
+std::uint64_t hash(std::uint64_t h, const Ch* first, const Ch* last) noexcept
+{
+    constexpr std::uint64_t prime = 1099511628211ULL;
+    for (; first != last; ++first) {
+        h ^= static_cast<std::uint64_t>(
+                static_cast<std::make_unsigned_t<Ch>>(*first));
+        h *= prime;
+    }
+    return h;
+}
+
+// Has the low bits, which pick slots, depend on all bits of the hash
+inline std::size_t slot_index(std::uint64_t h, std::size_t mask) noexcept
+{
+    h ^= h >> 31;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 32;
+    return static_cast<std::size_t>(h) & mask;
+}
+
+// An open addressing hash table whose values are stored contiguously and
+// whose slots have the hashes of the values inline so that most of the
+// probes touch only the slot array; the distinct values are also indexed in
+// lexicographical order so that a value can be looked up fragment by
+// fragment
+template <class Ch, class Tr, class Allocator>
+class table
+{
+    using at_t = std::allocator_traits<Allocator>;
+    using view_t = std::basic_string_view<Ch, Tr>;
+
+    static constexpr std::size_t vacant =
+        std::numeric_limits<std::size_t>::max();
+
+    struct slot
+    {
+        std::uint64_t hash;
+        std::size_t index;      // vacant if no values are here
+    };
+
+    using size_a_t = typename at_t::template rebind_alloc<std::size_t>;
+    using slot_a_t = typename at_t::template rebind_alloc<slot>;
+
+    std::vector<Ch, Allocator> chars_;
+    std::vector<std::size_t, size_a_t> offsets_;
+    std::vector<slot, slot_a_t> slots_;
+    std::vector<std::size_t, size_a_t> sorted_;
+
+public:
+    // A range of sorted_, all of whose elements have the fragments fed so
+    // far as their prefix
+    using candidates = std::pair<std::size_t, std::size_t>;
+
+    template <class InputIterator>
+    table(InputIterator first, InputIterator last, const Allocator& alloc) :
+        chars_(alloc), offsets_(size_a_t(alloc)), slots_(slot_a_t(alloc)),
+        sorted_(size_a_t(alloc))
+    {
+        offsets_.push_back(0);                                      // throw
+        for (; first != last; ++first) {
+            const view_t v(*first);
+            chars_.insert(chars_.cend(), v.cbegin(), v.cend());     // throw
+            offsets_.push_back(chars_.size());                      // throw
+        }
+
+        // At most half of the slots are occupied to keep probes short
+        const std::size_t n = offsets_.size() - 1;
+        std::size_t capacity = 1;
+        while (capacity < n * 2) {
+            capacity *= 2;
+        }
+        slots_.assign(capacity, slot{ 0, vacant });                 // throw
+
+        const std::size_t mask = capacity - 1;
+        for (std::size_t i = 0; i < n; ++i) {
+            const auto v = value(i);
+            const auto h = hash(hash_basis, v.data(), v.data() + v.size());
+            std::size_t j = slot_index(h, mask);
+            for (; slots_[j].index != vacant; j = (j + 1) & mask) {
+                if ((slots_[j].hash == h) && (value(slots_[j].index) == v)) {
+                    break;
+                }
+            }
+            if (slots_[j].index == vacant) {
+                slots_[j] = slot{ h, i };
+                sorted_.push_back(i);                               // throw
+            }
+        }
+        std::sort(sorted_.begin(), sorted_.end(),
+            [this](std::size_t l, std::size_t r) {
+                return value(l) < value(r);
+            });
+    }
+
+    Allocator get_allocator() const noexcept
+    {
+        return chars_.get_allocator();
+    }
+
+    std::size_t size() const noexcept
+    {
+        return sorted_.size();
+    }
+
+    bool contains(view_t v) const noexcept
+    {
+        const auto h = hash(hash_basis, v.data(), v.data() + v.size());
+        return probe(h, [this, v](std::size_t i) {
+            return value(i) == v;
+        });
+    }
+
+    candidates all_candidates() const noexcept
+    {
+        return candidates(0, sorted_.size());
+    }
+
+    // Narrows c down to the values which have fragment at offset, where
+    // offset is the total length of the fragments fed before
+    candidates narrow(candidates c, std::size_t offset, view_t fragment)
+        const noexcept
+    {
+        if (fragment.empty() || (c.first == c.second)) {
+            return c;
+        }
+        const auto part = [this, offset, n = fragment.size()]
+                          (std::size_t i) {
+            return value(i).substr(offset, n);
+        };
+        const auto b = sorted_.cbegin();
+        const auto first = std::lower_bound(b + c.first, b + c.second,
+            fragment, [part](std::size_t i, view_t f) {
+                return part(i) < f;
+            });
+        const auto last = std::upper_bound(first, b + c.second,
+            fragment, [part](view_t f, std::size_t i) {
+                return f < part(i);
+            });
+        return candidates(static_cast<std::size_t>(first - b),
+                          static_cast<std::size_t>(last - b));
+    }
+
+    // Tells whether the value formed by the fragments fed so far, whose
+    // total length is length, is a member; as the prefixes of a value
+    // precede it, such a member would be the first of c
+    bool contains(candidates c, std::size_t length) const noexcept
+    {
+        return (c.first != c.second)
+            && (value(sorted_[c.first]).size() == length);
+    }
+
+private:
+    view_t value(std::size_t i) const noexcept
+    {
+        return view_t(chars_.data() + offsets_[i],
+                      offsets_[i + 1] - offsets_[i]);
+    }
+
+    template <class F>
+    bool probe(std::uint64_t h, F matches) const noexcept
+    {
+        const std::size_t mask = slots_.size() - 1;
+        for (std::size_t j = slot_index(h, mask); ; j = (j + 1) & mask) {
+            const auto& s = slots_[j];
+            if (s.index == vacant) {
+                return false;
+            } else if ((s.hash == h) && matches(s.index)) {
+                return true;
+            }
+        }
+    }
+};
+
+} // end detail::value_set
+
+template <class Ch, class Tr = std::char_traits<Ch>,
+          class Allocator = std::allocator<Ch>>
+class field_value_set
+{
+    using table_t = detail::value_set::table<Ch, Tr, Allocator>;
+
+    // Shared among the copies so that copying an object is cheap; the
+    // table is never modified after the construction
+    std::shared_ptr<const table_t> table_;
+    incremental_hashing hashing_;
+    // The members which can be formed by the fragments fed so far and the
+    // total length of them
+    typename table_t::candidates candidates_;
+    std::size_t length_;
+
+public:
+    using char_type = Ch;
+    using traits_type = Tr;
+    using allocator_type = Allocator;
+
+    template <class InputIterator>
+    field_value_set(InputIterator first, InputIterator last,
+        incremental_hashing hashing = incremental_hashing::no) :
+        field_value_set(std::allocator_arg, Allocator(),
+            first, last, hashing)
+    {}
+
+    template <class InputIterator>
+    field_value_set(std::allocator_arg_t, const Allocator& alloc,
+        InputIterator first, InputIterator last,
+        incremental_hashing hashing = incremental_hashing::no) :
+        table_(std::allocate_shared<table_t>(
+            alloc, first, last, alloc)),                           // throw
+        hashing_(hashing), candidates_(table_->all_candidates()),
+        length_(0)
+    {}
+
+    field_value_set(
+        std::initializer_list<std::basic_string_view<Ch, Tr>> values,
+        incremental_hashing hashing = incremental_hashing::no) :
+        field_value_set(values.begin(), values.end(), hashing)
+    {}
+
+    field_value_set(const field_value_set&) = default;
+    field_value_set(field_value_set&&) = default;
+    ~field_value_set() = default;
+    field_value_set& operator=(const field_value_set&) = default;
+    field_value_set& operator=(field_value_set&&) = default;
+
+    allocator_type get_allocator() const noexcept
+    {
+        return table_->get_allocator();
+    }
+
+    std::size_t size() const noexcept
+    {
+        return table_->size();
+    }
+
+    bool operator()(std::basic_string_view<Ch, Tr> value) const noexcept
+    {
+        return table_->contains(value);
+    }
+
+    bool is_incremental() const noexcept
+    {
+        return hashing_ == incremental_hashing::yes;
+    }
+
+    void start_value() noexcept
+    {
+        candidates_ = table_->all_candidates();
+        length_ = 0;
+    }
+
+    void update_value(const Ch* first, const Ch* last) noexcept
+    {
+        const std::basic_string_view<Ch, Tr> fragment(first, last - first);
+        candidates_ = table_->narrow(candidates_, length_, fragment);
+        length_ += fragment.size();
+    }
+
+    bool finalize_value(const Ch* first, const Ch* last) noexcept
+    {
+        bool r;
+        if (length_ == 0) {
+            // The value has come in one piece, so it can be compared with
+            // the members
+            r = table_->contains(
+                std::basic_string_view<Ch, Tr>(first, last - first));
+        } else {
+            update_value(first, last);
+            r = table_->contains(candidates_, length_);
+        }
+        start_value();
+        return r;
+    }
+};
+
+template <class InputIterator, class... Args>
+field_value_set(InputIterator, InputIterator, Args...)
+ -> field_value_set<typename std::iterator_traits<InputIterator>::
+                        value_type::value_type>;
+
+template <class Allocator, class InputIterator, class... Args>
+field_value_set(std::allocator_arg_t, Allocator,
+    InputIterator, InputIterator, Args...)
+ -> field_value_set<typename std::iterator_traits<InputIterator>::
+                        value_type::value_type,
+                    std::char_traits<typename std::iterator_traits<
+                        InputIterator>::value_type::value_type>,
+                    Allocator>;
+
+}
+
+#endif
@@ -0,0 +1,232 @@
+/**
+ * These codes are licensed under the Unlicense.
+ * http://unlicense.org
+ */
+
+#ifndef COMMATA_GUARD_3B8E6C2A_5D41_4F7E_A0C9_71E2D84B9F63
+#define COMMATA_GUARD_3B8E6C2A_5D41_4F7E_A0C9_71E2D84B9F63
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+
+namespace commata {
+
+// A memory resource that serves memory blocks by bumping a pointer in large
+// chunks obtained from the upstream resource and never frees individual
+// blocks; the chunks are returned to the upstream only by release() or the
+// destructor
+class monotonic_arena :
+    public std::pmr::memory_resource
+{
+public:
+    static constexpr std::size_t default_chunk_size = 64U * 1024U;
+    static constexpr std::size_t max_chunk_size = 16U * 1024U * 1024U;
+
+private:
+    struct chunk
+    {
+        chunk* next;
+        std::size_t size;
+    };
+
+    static constexpr std::size_t chunk_alignment =
+        alignof(std::max_align_t);
+    static constexpr std::size_t chunk_header_size =
+        (sizeof(chunk) + chunk_alignment - 1) / chunk_alignment
+      * chunk_alignment;
+
+    std::pmr::memory_resource* upstream_;
+    chunk* chunks_;
+    char* current_;             // the free space of the front chunk is
+    char* end_;                 // [current_, end_)
+    std::size_t next_chunk_size_;
+    std::size_t initial_chunk_size_;
+    std::size_t upstream_total_;
+
+public:
+    explicit monotonic_arena(
+        std::size_t initial_chunk_size = default_chunk_size,
+        std::pmr::memory_resource* upstream =
+            std::pmr::get_default_resource()) noexcept :
+        upstream_(upstream), chunks_(nullptr),
+        current_(nullptr), end_(nullptr),
+        next_chunk_size_(sanitize_chunk_size(initial_chunk_size)),
+        initial_chunk_size_(next_chunk_size_), upstream_total_(0)
+    {
+        assert(upstream_);
+    }
+
+    explicit monotonic_arena(std::pmr::memory_resource* upstream) noexcept :
+        monotonic_arena(default_chunk_size, upstream)
+    {}
+
+    monotonic_arena(const monotonic_arena&) = delete;
+    monotonic_arena& operator=(const monotonic_arena&) = delete;
+
+    ~monotonic_arena()
+    {
+        release();
+    }
+
+    // Returns all chunks to the upstream; all memory blocks served so far
+    // are invalidated
+    void release() noexcept
+    {
+        while (chunks_) {
+            const auto c = chunks_;
+            chunks_ = c->next;
+            upstream_->deallocate(c, c->size, chunk_alignment);
+        }
+        current_ = nullptr;
+        end_ = nullptr;
+        next_chunk_size_ = initial_chunk_size_;
+        upstream_total_ = 0;
+    }
+
+    std::pmr::memory_resource* upstream_resource() const noexcept
+    {
+        return upstream_;
+    }
+
+    // Returns the number of bytes currently obtained from the upstream
+    std::size_t upstream_total() const noexcept
+    {
+        return upstream_total_;
+    }
+
+    // Non-virtual counterpart of allocate, which can be inlined
+    [[nodiscard]] void* bump(std::size_t bytes,
+        std::size_t alignment = alignof(std::max_align_t))
+    {
+        assert((alignment > 0) && ((alignment & (alignment - 1)) == 0));
+        if (bytes == 0) {
+            bytes = 1;
+        }
+        std::size_t space = end_ - current_;
+        void* p = current_;
+        if (!std::align(alignment, bytes, p, space)) {
+            p = bump_slow(bytes, alignment);                    // throw
+        }
+        current_ = static_cast<char*>(p) + bytes;
+        return p;
+    }
+
+private:
+    static std::size_t sanitize_chunk_size(std::size_t size) noexcept
+    {
+        return std::clamp(size, chunk_header_size * 2, max_chunk_size);
+    }
+
+    void* bump_slow(std::size_t bytes, std::size_t alignment)
+    {
+        constexpr auto max = std::numeric_limits<std::size_t>::max();
+        const auto padding = std::max(alignment, chunk_alignment)
+                           - chunk_alignment;
+        if (bytes > max - chunk_header_size - padding) {
+            throw std::bad_alloc();
+        }
+        const auto size = std::max(
+            next_chunk_size_, chunk_header_size + padding + bytes);
+        const auto c = static_cast<chunk*>(
+            upstream_->allocate(size, chunk_alignment));        // throw
+        c->next = chunks_;
+        c->size = size;
+        chunks_ = c;
+        upstream_total_ += size;
+        next_chunk_size_ = std::min(next_chunk_size_ * 2, max_chunk_size);
+
+        // A large block may make the rest of the previous chunk wasted,
+        // which is tolerable for the purpose of this resource
+        current_ = reinterpret_cast<char*>(c) + chunk_header_size;
+        end_ = reinterpret_cast<char*>(c) + size;
+        std::size_t space = end_ - current_;
+        void* p = current_;
+        [[maybe_unused]] const auto aligned =
+            std::align(alignment, bytes, p, space);
+        assert(aligned);
+        return p;
+    }
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        return bump(bytes, alignment);                          // throw
+    }
+
+    void do_deallocate(void*, std::size_t, std::size_t) noexcept override
+    {}
+
+    bool do_is_equal(const std::pmr::memory_resource& other)
+        const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+// A stateful allocator that allocates from a monotonic_arena object without
+// indirection through virtual functions; it can be used wherever allocators
+// are taken, and the arena object can be passed to any std::pmr facilities
+// as well
+template <class T>
+class monotonic_arena_allocator
+{
+    template <class U>
+    friend class monotonic_arena_allocator;
+
+    monotonic_arena* arena_;
+
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+    using is_always_equal = std::false_type;
+
+    monotonic_arena_allocator(monotonic_arena& arena) noexcept :
+        arena_(std::addressof(arena))
+    {}
+
+    template <class U>
+    monotonic_arena_allocator(
+        const monotonic_arena_allocator<U>& other) noexcept :
+        arena_(other.arena_)
+    {}
+
+    [[nodiscard]] T* allocate(std::size_t n)
+    {
+        if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(arena_->bump(n * sizeof(T), alignof(T)));
+                                                                // throw
+    }
+
+    void deallocate(T*, std::size_t) noexcept
+    {}
+
+    monotonic_arena& arena() const noexcept
+    {
+        return *arena_;
+    }
+
+    template <class U>
+    bool operator==(const monotonic_arena_allocator<U>& other) const noexcept
+    {
+        return arena_ == other.arena_;
+    }
+
+    template <class U>
+    bool operator!=(const monotonic_arena_allocator<U>& other) const noexcept
+    {
+        return !(*this == other);
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,332 @@
+/**
+ * These codes are licensed under the Unlicense.
+ * http://unlicense.org
+ */
+
+#ifndef COMMATA_GUARD_03699627_9F3A_4CEF_9489_3058F30AAA5B
+#define COMMATA_GUARD_03699627_9F3A_4CEF_9489_3058F30AAA5B
+
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <future>
+#include <memory>
+#include <optional>
+#include <streambuf>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "parse_csv.hpp"
+#include "parse_tsv.hpp"
+#include "record_extractor.hpp"
+#include "text_error.hpp"
+#include "wrapper_handlers.hpp"
+
+#include "detail/key_chars.hpp"
+#include "detail/vector_streambuf.hpp"
+
+namespace commata {
+namespace detail::parallel_extraction {
+
+constexpr std::size_t default_chunk_size = static_cast<std::size_t>(1U << 20);
+
+template <class TableSource>
+struct dialect
+{
+    static_assert(csv::is_csv_source_v<TableSource>
+               || tsv::is_tsv_source_v<TableSource>,
+        "Parallel extraction is available only for csv_source and "
+        "tsv_source");
+
+    // Returns the position next to the last line feed that ends a record in
+    // [first, last) or nullptr if none, where first shall be at a beginning
+    // of a record
+    template <class Tr, class Ch>
+    static const Ch* records_end(const Ch* first, const Ch* last)
+    {
+        using view_t = std::basic_string_view<Ch, Tr>;
+        if constexpr (csv::is_csv_source_v<TableSource>) {
+            // A line feed is in a quoted value if and only if an odd number
+            // of quotation marks precede it, because the parser rejects
+            // quotation marks in unquoted values
+            const Ch* end = nullptr;
+            bool quoted = false;
+            for (const Ch* p = first; ; ) {
+                const Ch* q = Tr::find(p, last - p, key_chars<Ch>::dquote_c);
+                if (!q) {
+                    q = last;
+                }
+                if (!quoted) {
+                    const auto i = view_t(p, q - p).rfind(key_chars<Ch>::lf_c);
+                    if (i != view_t::npos) {
+                        end = p + (i + 1);
+                    }
+                }
+                if (q == last) {
+                    return end;
+                }
+                quoted = !quoted;
+                p = q + 1;
+            }
+        } else {
+            const auto i =
+                view_t(first, last - first).rfind(key_chars<Ch>::lf_c);
+            return (i != view_t::npos) ? first + (i + 1) : nullptr;
+        }
+    }
+
+    template <class Ch, class Tr>
+    static auto make_source(std::basic_string_view<Ch, Tr> chunk) noexcept
+    {
+        if constexpr (csv::is_csv_source_v<TableSource>) {
+            return make_csv_source(chunk);
+        } else {
+            return make_tsv_source(chunk);
+        }
+    }
+};
+
+// Reads the input into chunks each of which consists of whole records
+template <class TableSource, class Allocator>
+class chunk_reader
+{
+    using char_t = typename TableSource::char_type;
+    using traits_t = typename TableSource::traits_type;
+    using chunk_t = std::vector<char_t, Allocator>;
+
+    typename TableSource::input_type* in_;
+    std::size_t chunk_size_;
+    chunk_t rest_;
+    bool eof_;
+
+public:
+    chunk_reader(typename TableSource::input_type& in,
+        std::size_t chunk_size, const Allocator& alloc) :
+        in_(std::addressof(in)), chunk_size_(chunk_size), rest_(alloc),
+        eof_(false)
+    {}
+
+    // Returns false if no more chars are left
+    bool next(chunk_t& chunk)
+    {
+        chunk.clear();
+        chunk.swap(rest_);
+        std::size_t length = chunk.size();
+        for (;;) {
+            if (!eof_) {
+                // A record longer than a chunk makes the chunk twice as long
+                // to keep rescanning the record not too costly
+                length = fill(chunk, length,
+                    std::max(chunk_size_, length));                 // throw
+            }
+            if (eof_) {
+                chunk.resize(length);
+                return length > 0;
+            }
+            const char_t* const first = chunk.data();
+            if (const auto e = dialect<TableSource>::template
+                    records_end<traits_t>(first, first + length)) {
+                rest_.assign(e, first + length);                    // throw
+                chunk.resize(e - first);
+                return true;
+            }
+        }
+    }
+
+private:
+    std::size_t fill(chunk_t& chunk, std::size_t length, std::size_t n)
+    {
+        chunk.resize(length + n);                                   // throw
+        while (length < chunk.size()) {
+            const std::size_t r = (*in_)(
+                chunk.data() + length, chunk.size() - length);      // throw
+            if (r == 0) {
+                eof_ = true;
+                break;
+            }
+            length += r;
+        }
+        return length;
+    }
+};
+
+// Returns the number of physical lines in the chunk
+template <class TableSource, class Handler, class Ch, class Allocator>
+std::size_t parse_chunk(const std::vector<Ch, Allocator>& chunk,
+    Handler& handler, const Allocator& alloc)
+{
+    using view_t =
+        std::basic_string_view<Ch, typename TableSource::traits_type>;
+    auto p = dialect<TableSource>::make_source(
+        view_t(chunk.data(), chunk.size()))(wrap_ref(handler), 0, alloc);
+    p();                                                            // throw
+    return p.get_physical_position().first + 1;     // npos + 1 is zero
+}
+
+// Has the physical positions of the errors thrown from f counted from the
+// beginning of the whole input
+template <class F>
+auto with_line_offset(std::size_t offset, F f) -> decltype(f())
+{
+    try {
+        return f();                                                 // throw
+    } catch (text_error& e) {
+        if (const auto pos = e.get_physical_position();
+                pos && (pos->first != text_error::npos)) {
+            e.set_physical_position(pos->first + offset, pos->second);
+        }
+        throw;
+    }
+}
+
+template <class TableSource, class Ch, class Tr, class Extractor,
+    class FieldValuePred, class Allocator>
+void extract(TableSource& in, std::basic_streambuf<Ch, Tr>& out,
+    Extractor& extractor, const FieldValuePred& field_value_pred,
+    std::size_t thread_count, std::size_t chunk_size,
+    const Allocator& alloc)
+{
+    static_assert(std::is_same_v<Ch, typename TableSource::char_type>);
+    static_assert(std::is_copy_constructible_v<FieldValuePred>,
+        "FieldValuePred shall be copied for each chunk");
+
+    using chunk_t = std::vector<Ch, Allocator>;
+
+    struct result
+    {
+        chunk_t output;
+        std::size_t line_count;
+        std::exception_ptr error;   // thrown after output was written
+    };
+
+    chunk_reader<TableSource, Allocator> reader(in.get_input(),
+        ((chunk_size > 0) ? chunk_size : default_chunk_size), alloc);
+    std::size_t line_offset = 0;
+    chunk_t chunk(alloc);
+
+    // Records up to the end of the header are processed sequentially to
+    // know the index of the target field
+    do {
+        if (!reader.next(chunk)) {                                  // throw
+            return;
+        }
+        line_offset += with_line_offset(line_offset, [&] {
+            return parse_chunk<TableSource>(chunk, extractor, alloc);
+        });                                                         // throw
+    } while (extractor.is_in_header());
+    const std::size_t target_field_index = extractor.target_field_index();
+
+    if (thread_count == 0) {
+        thread_count = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+
+    // At most thread_count chunks are in flight, and their outputs are
+    // written in the input order
+    std::deque<std::future<result>> results;
+    bool has_more = true;
+    while (has_more || !results.empty()) {
+        while (has_more && (results.size() < thread_count)) {
+            if (reader.next(chunk)) {                               // throw
+                results.push_back(std::async(std::launch::async,
+                    [target_field_index, field_value_pred, alloc,
+                     c = std::move(chunk)]() mutable {
+                        vector_streambuf<Ch, Tr, Allocator> o(alloc);
+                        record_extractor_with_indexed_key<
+                                FieldValuePred, Ch, Tr, Allocator>
+                            x(std::allocator_arg, alloc, o,
+                              target_field_index, std::move(field_value_pred),
+                              std::nullopt);
+                        try {
+                            const auto n =
+                                parse_chunk<TableSource>(c, x, alloc);
+                            return result{ o.release(), n, nullptr };
+                        } catch (...) {
+                            // The records forwarded before the error are
+                            // kept as record_extractor writes them before
+                            // the error is rethrown
+                            return result{ o.release(), 0,
+                                           std::current_exception() };
+                        }
+                    }));                                            // throw
+                chunk = chunk_t(alloc);
+            } else {
+                has_more = false;
+            }
+        }
+        if (!results.empty()) {
+            auto r = with_line_offset(line_offset, [&results] {
+                return results.front().get();
+            });                                                     // throw
+            results.pop_front();
+            out.sputn(r.output.data(), r.output.size());
+            if (r.error) {
+                with_line_offset(line_offset, [&r] {
+                    std::rethrow_exception(r.error);
+                });                                                 // throw
+            }
+            line_offset += r.line_count;
+        }
+    }
+}
+
+} // end detail::parallel_extraction
+
+template <class TableSource, class Allocator, class Ch, class Tr,
+    class FieldNamePred, class FieldValuePred>
+auto extract_records_in_parallel(
+    std::allocator_arg_t, const Allocator& alloc,
+    TableSource&& in, std::basic_streambuf<Ch, Tr>& out,
+    FieldNamePred&& field_name_pred, FieldValuePred&& field_value_pred,
+    header_forwarding header = header_forwarding::yes,
+    std::size_t thread_count = 0, std::size_t chunk_size = 0)
+ -> std::enable_if_t<!std::is_integral_v<std::decay_t<FieldNamePred>>>
+{
+    auto fvp = detail::record_extraction::make_string_pred<Ch, Tr>(
+        std::forward<FieldValuePred>(field_value_pred));
+    record_extractor extractor(std::allocator_arg, alloc, out,
+        detail::record_extraction::make_string_pred<Ch, Tr>(
+            std::forward<FieldNamePred>(field_name_pred)),
+        decltype(fvp)(fvp), header);
+    std::decay_t<TableSource> src(std::forward<TableSource>(in));
+    detail::parallel_extraction::extract(
+        src, out, extractor, fvp, thread_count, chunk_size, alloc);
+}
+
+template <class TableSource, class Allocator, class Ch, class Tr,
+    class FieldValuePred>
+void extract_records_in_parallel(
+    std::allocator_arg_t, const Allocator& alloc,
+    TableSource&& in, std::basic_streambuf<Ch, Tr>& out,
+    std::size_t target_field_index, FieldValuePred&& field_value_pred,
+    std::optional<header_forwarding> header = header_forwarding::yes,
+    std::size_t thread_count = 0, std::size_t chunk_size = 0)
+{
+    auto fvp = detail::record_extraction::make_string_pred<Ch, Tr>(
+        std::forward<FieldValuePred>(field_value_pred));
+    record_extractor_with_indexed_key extractor(std::allocator_arg, alloc,
+        out, target_field_index, decltype(fvp)(fvp), header);
+    std::decay_t<TableSource> src(std::forward<TableSource>(in));
+    detail::parallel_extraction::extract(
+        src, out, extractor, fvp, thread_count, chunk_size, alloc);
+}
+
+template <class TableSource, class... Args>
+auto extract_records_in_parallel(TableSource&& in, Args&&... args)
+ -> std::enable_if_t<
+        !std::is_same_v<std::decay_t<TableSource>, std::allocator_arg_t>,
+        decltype(extract_records_in_parallel(std::allocator_arg,
+            std::allocator<typename std::decay_t<TableSource>::char_type>(),
+            std::forward<TableSource>(in), std::forward<Args>(args)...))>
+{
+    return extract_records_in_parallel(std::allocator_arg,
+        std::allocator<typename std::decay_t<TableSource>::char_type>(),
+        std::forward<TableSource>(in), std::forward<Args>(args)...);
+}
+
+}
+
+#endif
@@ -10,6 +10,7 @@
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <string>
 #include <tuple>
 #include <type_traits>
 #include <utility>
@@ -509,10 +510,22 @@ class parser :
 {
 public:
     static constexpr state first_state = state::after_lf;
+    static constexpr state after_cr_state = state::after_cr;
+    static constexpr state after_lf_state = state::after_lf;
 
     using detail::base_parser<Input, Handler, state, parser<Input, Handler>>::
         base_parser;
 
+    // Tells whether a line without line breaks in it can be skipped without
+    // the state machine
+    template <class Ch>
+    static bool is_plain_line(const Ch* first, const Ch* last)
+    {
+        using ch_t = std::remove_const_t<Ch>;
+        return !std::char_traits<ch_t>::find(
+            first, last - first, key_chars<ch_t>::dquote_c);
+    }
+
     template <class F>
     static void step(state s, F f)
     {
@@ -245,10 +245,20 @@ class parser :
 {
 public:
     static constexpr state first_state = state::after_lf;
+    static constexpr state after_cr_state = state::after_cr;
+    static constexpr state after_lf_state = state::after_lf;
 
     using detail::base_parser<Input, Handler, state, parser<Input, Handler>>::
         base_parser;
 
+    // Tells whether a line without line breaks in it can be skipped without
+    // the state machine
+    template <class Ch>
+    static bool is_plain_line(const Ch* /*first*/, const Ch* /*last*/)
+    {
+        return true;
+    }
+
     template <class F>
     static void step(state s, F f)
     {
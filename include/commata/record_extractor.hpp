@@ -6,6 +6,8 @@
 #ifndef COMMATA_GUARD_D53E08F9_CF1C_4762_BF77_1A6FB68C6A96
 #define COMMATA_GUARD_D53E08F9_CF1C_4762_BF77_1A6FB68C6A96
 
+#include <algorithm>
+#include <array>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
@@ -18,6 +20,7 @@
 #include <stdexcept>
 #include <streambuf>
 #include <string_view>
+#include <tuple>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -138,6 +141,29 @@ template <class Stream, class T>
 constexpr bool is_stream_writable_v =
     decltype(is_stream_writable_impl::check<Stream, T>(nullptr))();
 
+template <class Ch>
+struct is_incremental_pred_impl
+{
+    template <class T>
+    static auto check(T*) -> decltype(
+        std::declval<bool&>() = std::declval<const T&>().is_incremental(),
+        std::declval<T&>().start_value(),
+        std::declval<T&>().update_value(
+            std::declval<const Ch*>(), std::declval<const Ch*>()),
+        std::declval<bool&>() = std::declval<T&>().finalize_value(
+            std::declval<const Ch*>(), std::declval<const Ch*>()),
+        std::true_type());
+
+    template <class>
+    static auto check(...) -> std::false_type;
+};
+
+// Incremental predicates can be fed with the fragments of a field value
+// instead of the whole of it
+template <class T, class Ch>
+constexpr bool is_incremental_pred_v =
+    decltype(is_incremental_pred_impl<Ch>::template check<T>(nullptr))();
+
 template <class Ch, class Tr, class T>
 constexpr bool is_plain_field_name_pred_v =
     std::is_pointer_v<T>
@@ -214,35 +240,262 @@ public:
 
 constexpr std::size_t record_extractor_npos = static_cast<std::size_t>(-1);
 
+enum class key_combination : std::uint_fast8_t
+{
+    all, any
+};
+
 namespace detail::record_extraction {
 
-template <class FieldNamePred, class FieldValuePred,
-    class Ch, class Tr, class Allocator>
-class impl
+enum class record_mode : std::int_fast8_t
 {
-    using alloc_t = detail::allocation_only_allocator<Allocator>;
+    unknown,
+    include,
+    exclude
+};
+
+// Decides records with one target field
+template <class FieldNamePred, class FieldValuePred, class Ch, class Tr>
+class single_key
+{
+    FieldNamePred field_name_pred_;
+    FieldValuePred field_value_pred_;
+    std::size_t target_field_index_;
+
+public:
+    template <class FieldNamePredR, class FieldValuePredR>
+    single_key(FieldNamePredR&& field_name_pred,
+            FieldValuePredR&& field_value_pred,
+            std::size_t target_field_index) :
+        field_name_pred_(std::forward<FieldNamePredR>(field_name_pred)),
+        field_value_pred_(std::forward<FieldValuePredR>(field_value_pred)),
+        target_field_index_(target_field_index)
+    {}
+
+    single_key(single_key&&) = default;
+    ~single_key() = default;
+
+    std::size_t target_field_index() const noexcept
+    {
+        return target_field_index_;
+    }
+
+    bool is_resolved() const noexcept
+    {
+        return target_field_index_ != record_extractor_npos;
+    }
+
+    // Returns whether the field is a target field
+    bool resolve(std::size_t field_index,
+        std::basic_string_view<Ch, Tr> field_name)
+    {
+        if (field_name_pred_(field_name)) {
+            target_field_index_ = field_index;
+            return true;
+        } else {
+            return false;
+        }
+    }
 
-    enum class record_mode : std::int_fast8_t
+    bool is_target(std::size_t field_index) const noexcept
     {
-        unknown,
-        include,
-        exclude
-    };
+        return field_index == target_field_index_;
+    }
+
+    void start_record()
+    {
+        if constexpr (is_incremental_pred_v<FieldValuePred, Ch>) {
+            field_value_pred_.start_value();
+        }
+    }
+
+    // Returns whether the fragment has been consumed, in which case it need
+    // not to be buffered
+    bool update_value(std::size_t /*field_index*/,
+        const Ch* first, const Ch* last)
+    {
+        if constexpr (is_incremental_pred_v<FieldValuePred, Ch>) {
+            if (field_value_pred_.is_incremental()) {
+                field_value_pred_.update_value(first, last);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // field_value is the last fragment if the preceding ones have been
+    // consumed by update_value, or the whole value otherwise
+    record_mode decide(std::size_t /*field_index*/,
+        std::basic_string_view<Ch, Tr> field_value)
+    {
+        bool r;
+        if constexpr (is_incremental_pred_v<FieldValuePred, Ch>) {
+            r = field_value_pred_.is_incremental() ?
+                field_value_pred_.finalize_value(field_value.data(),
+                    field_value.data() + field_value.size()) :
+                field_value_pred_(field_value);
+        } else {
+            r = field_value_pred_(field_value);
+        }
+        return r ? record_mode::include : record_mode::exclude;
+    }
+
+    void write_unresolved(std::ostream& o, std::string_view prefix) const
+    {
+        write_formatted_field_name_of<Tr>(o, prefix, field_name_pred_,
+            static_cast<const Ch*>(nullptr));
+    }
+};
+
+// Decides records with several target fields whose results are combined
+template <class Keys, class Ch, class Tr>
+class multiple_keys;
+
+template <class... FieldNamePreds, class... FieldValuePreds,
+          class Ch, class Tr>
+class multiple_keys<
+    std::tuple<std::pair<FieldNamePreds, FieldValuePreds>...>, Ch, Tr>
+{
+    static constexpr std::size_t n = sizeof...(FieldNamePreds);
+
+    std::tuple<std::pair<FieldNamePreds, FieldValuePreds>...> keys_;
+    std::array<std::size_t, n> target_field_indices_;
+    key_combination combination_;
+    std::size_t undecided_count_;   // number of keys not decided in the
+                                    // current record
+
+public:
+    static_assert(n > 0);
+
+    template <class KeysR>
+    multiple_keys(key_combination combination, KeysR&& keys) :
+        keys_(std::forward<KeysR>(keys)), combination_(combination),
+        undecided_count_(n)
+    {
+        target_field_indices_.fill(record_extractor_npos);
+    }
+
+    multiple_keys(multiple_keys&&) = default;
+    ~multiple_keys() = default;
+
+    bool is_resolved() const noexcept
+    {
+        return std::find(target_field_indices_.cbegin(),
+                         target_field_indices_.cend(), record_extractor_npos)
+            == target_field_indices_.cend();
+    }
+
+    // Returns whether the field is a target field
+    bool resolve(std::size_t field_index,
+        std::basic_string_view<Ch, Tr> field_name)
+    {
+        bool resolved = false;
+        for_each_key(
+            [this, field_index, field_name, &resolved](auto& key, auto i) {
+                auto& target = target_field_indices_[i];
+                if ((target == record_extractor_npos)
+                 && key.first(field_name)) {
+                    target = field_index;
+                    resolved = true;
+                }
+                return false;
+            });
+        return resolved;
+    }
+
+    bool is_target(std::size_t field_index) const noexcept
+    {
+        return std::find(target_field_indices_.cbegin(),
+                         target_field_indices_.cend(), field_index)
+            != target_field_indices_.cend();
+    }
+
+    void start_record() noexcept
+    {
+        undecided_count_ = n;
+    }
+
+    // The predicates of the keys are always given whole values, for keys
+    // sharing a field could not agree on how to receive it otherwise
+    bool update_value(std::size_t /*field_index*/,
+        const Ch* /*first*/, const Ch* /*last*/) noexcept
+    {
+        return false;
+    }
+
+    // The record is decided as soon as the result of one key settles it
+    record_mode decide(std::size_t field_index,
+        std::basic_string_view<Ch, Tr> field_value)
+    {
+        auto mode = record_mode::unknown;
+        for_each_key(
+            [this, field_index, field_value, &mode](auto& key, auto i) {
+                if (target_field_indices_[i] != field_index) {
+                    return false;
+                }
+                const bool r = key.second(field_value);
+                if ((r == (combination_ == key_combination::any))
+                 || (--undecided_count_ == 0)) {
+                    mode = r ? record_mode::include : record_mode::exclude;
+                    return true;
+                }
+                return false;
+            });
+        return mode;
+    }
+
+    void write_unresolved(std::ostream& o, std::string_view prefix) const
+    {
+        for_each_key([this, &o, prefix](const auto& key, auto i) {
+            if (target_field_indices_[i] == record_extractor_npos) {
+                write_formatted_field_name_of<Tr>(o, prefix, key.first,
+                    static_cast<const Ch*>(nullptr));
+                return true;
+            }
+            return false;
+        });
+    }
+
+private:
+    // Applies f to the keys in order until it returns true
+    template <class F>
+    void for_each_key(F f)
+    {
+        for_each_key_impl(keys_, f, std::make_index_sequence<n>());
+    }
+
+    template <class F>
+    void for_each_key(F f) const
+    {
+        for_each_key_impl(keys_, f, std::make_index_sequence<n>());
+    }
+
+    template <class K, class F, std::size_t... Is>
+    static void for_each_key_impl(K& keys, F& f, std::index_sequence<Is...>)
+    {
+        (f(std::get<Is>(keys), std::integral_constant<std::size_t, Is>())
+      || ...);
+    }
+};
+
+template <class Keys, class Ch, class Tr, class Allocator>
+class impl
+{
+    using alloc_t = detail::allocation_only_allocator<Allocator>;
 
     std::size_t record_num_to_include_;
-    std::size_t target_field_index_;
 
     std::size_t field_index_;
     const Ch* current_begin_;   // current records's begin if not the buffer
                                 // switched, current buffer's begin otherwise
+    const Ch* run_begin_;       // included records in the current buffer
+    const Ch* run_end_;         // which are not written yet, or nullptr
     std::basic_streambuf<Ch, Tr>* out_;
 
     detail::base_member_pair<
-        FieldNamePred,
-        std::vector<Ch, alloc_t>/*field_buffer*/> nf_;
-    detail::base_member_pair<
-        FieldValuePred,
-        std::vector<Ch, alloc_t>/*record_buffer*/> vr_;
+        Keys,
+        std::vector<Ch, alloc_t>/*field_buffer*/> kf_;
+    std::vector<Ch, alloc_t> record_buffer_;
                                 // populated only after the buffer switched in
                                 // a unknown (included or not) record and
                                 // shall not overlap with interval
@@ -256,50 +509,17 @@ public:
     using traits_type = Tr;
     using allocator_type = Allocator;
 
-    template <class FieldNamePredR, class FieldValuePredR,
-        std::enable_if_t<!std::is_integral_v<FieldNamePredR>>* = nullptr>
-    impl(
-            std::allocator_arg_t, const Allocator& alloc,
-            std::basic_streambuf<Ch, Tr>& out,
-            FieldNamePredR&& field_name_pred,
-            FieldValuePredR&& field_value_pred,
-            bool includes_header, std::size_t max_record_num) :
-        impl(
-            std::allocator_arg, alloc, out,
-            std::forward<FieldNamePredR>(field_name_pred),
-            std::forward<FieldValuePredR>(field_value_pred),
-            record_extractor_npos, true, includes_header, max_record_num)
-    {}
-
-    template <class FieldValuePredR>
-    impl(
-            std::allocator_arg_t, const Allocator& alloc,
-            std::basic_streambuf<Ch, Tr>& out,
-            std::size_t target_field_index, FieldValuePredR&& field_value_pred,
-            bool has_header,
-            bool includes_header, std::size_t max_record_num) :
-        impl(
-            std::allocator_arg, alloc, out,
-            FieldNamePred(),
-            std::forward<FieldValuePredR>(field_value_pred),
-            target_field_index, has_header, includes_header, max_record_num)
-    {}
-
-private:
-    template <class FieldNamePredR, class FieldValuePredR>
+    template <class KeysR>
     impl(
         std::allocator_arg_t, const Allocator& alloc,
-        std::basic_streambuf<Ch, Tr>& out,
-        FieldNamePredR&& field_name_pred, FieldValuePredR&& field_value_pred,
-        std::size_t target_field_index, bool has_header,
+        std::basic_streambuf<Ch, Tr>& out, KeysR&& keys, bool has_header,
         bool includes_header, std::size_t max_record_num) :
         record_num_to_include_(max_record_num),
-        target_field_index_(target_field_index), field_index_(0),
-        current_begin_(nullptr), out_(std::addressof(out)),
-        nf_(std::forward<FieldNamePredR>(field_name_pred),
-            std::vector<Ch, alloc_t>(alloc_t(alloc))),
-        vr_(std::forward<FieldValuePredR>(field_value_pred),
+        field_index_(0), current_begin_(nullptr),
+        run_begin_(nullptr), run_end_(nullptr), out_(std::addressof(out)),
+        kf_(std::forward<KeysR>(keys),
             std::vector<Ch, alloc_t>(alloc_t(alloc))),
+        record_buffer_(alloc_t(alloc)),
         header_mode_(has_header ?
                         includes_header ?
                             record_mode::include : record_mode::exclude :
@@ -307,17 +527,15 @@ private:
         record_mode_(record_mode::exclude)
     {}
 
-public:
     impl(impl&& other)
-            noexcept(
-                std::is_nothrow_move_constructible_v<FieldNamePred>
-             && std::is_nothrow_move_constructible_v<FieldValuePred>) :
+            noexcept(std::is_nothrow_move_constructible_v<Keys>) :
         record_num_to_include_(other.record_num_to_include_),
-        target_field_index_(other.target_field_index_),
         field_index_(other.field_index_),
         current_begin_(other.current_begin_),
+        run_begin_(other.run_begin_), run_end_(other.run_end_),
         out_(std::exchange(other.out_, nullptr)),
-        nf_(std::move(other.nf_)), vr_(std::move(other.vr_)),
+        kf_(std::move(other.kf_)),
+        record_buffer_(std::move(other.record_buffer_)),
         header_mode_(other.header_mode_), record_mode_(other.record_mode_)
     {}
 
@@ -333,6 +551,7 @@ public:
 
     void end_buffer(const Ch* buffer_end)
     {
+        flush_run(buffer_end);
         switch (record_mode_) {
         case record_mode::include:
             flush_current(buffer_end);
@@ -351,13 +570,17 @@ public:
         current_begin_ = record_begin;
         record_mode_ = is_in_header() ? header_mode_ : record_mode::unknown;
         field_index_ = 0;
+        keys().start_record();
         assert(record_buffer().empty());
     }
 
     void update(const Ch* first, const Ch* last)
     {
-        if ((is_in_header() && (target_field_index_ == record_extractor_npos))
-         || (field_index_ == target_field_index_)) {
+        if (is_in_header() ?
+                !keys().is_resolved() :
+                ((record_mode_ == record_mode::unknown)
+              && keys().is_target(field_index_)
+              && !keys().update_value(field_index_, first, last))) {
             field_buffer().insert(field_buffer().cend(), first, last);
         }
     }
@@ -365,10 +588,11 @@ public:
     void finalize(const Ch* first, const Ch* last)
     {
         if (is_in_header()) {
-            if ((target_field_index_ == record_extractor_npos)
-             && with_field_buffer_appended(
-                    first, last, std::ref(nf_.base()))) {
-                target_field_index_ = field_index_;
+            if (!keys().is_resolved()) {
+                with_field_buffer_appended(first, last,
+                    [this](std::basic_string_view<Ch, Tr> field_name) {
+                        return keys().resolve(field_index_, field_name);
+                    });
             }
             ++field_index_;
             if (field_index_ >= record_extractor_npos) {
@@ -376,12 +600,19 @@ public:
             }
         } else {
             if ((record_mode_ == record_mode::unknown)
-             && (field_index_ == target_field_index_)) {
-                if (with_field_buffer_appended(
-                        first, last, std::ref(vr_.base()))) {
+             && keys().is_target(field_index_)) {
+                switch (with_field_buffer_appended(first, last,
+                    [this](std::basic_string_view<Ch, Tr> field_value) {
+                        return keys().decide(field_index_, field_value);
+                    })) {
+                case record_mode::include:
                     include();
-                } else {
+                    break;
+                case record_mode::exclude:
                     exclude();
+                    break;
+                default:
+                    break;
                 }
             }
             ++field_index_;
@@ -394,7 +625,7 @@ public:
     bool end_record(const Ch* record_end)
     {
         if (is_in_header()) {
-            if (target_field_index_ == record_extractor_npos) {
+            if (!keys().is_resolved()) {
                 throw no_matching_field();
             }
             flush_record(record_end);
@@ -402,6 +633,7 @@ public:
         } else if (flush_record(record_end)) {
             if (record_num_to_include_ > 0) {
                 if (record_num_to_include_ == 1) {
+                    flush_run(record_end);
                     return false;
                 }
                 --record_num_to_include_;
@@ -410,20 +642,47 @@ public:
         return true;
     }
 
+    void handle_exception()
+    {
+        // To write the records decided before the exception as ever
+        flush_run(run_end_);
+    }
+
     bool is_in_header() const noexcept
     {
         return header_mode_ != record_mode::unknown;
     }
 
+    // record_extractor_npos while the target field is unknown
+    std::size_t target_field_index() const noexcept
+    {
+        return keys().target_field_index();
+    }
+
 private:
-    decltype(auto) field_buffer()
+    Keys& keys() noexcept
+    {
+        return kf_.base();
+    }
+
+    const Keys& keys() const noexcept
+    {
+        return kf_.base();
+    }
+
+    decltype(auto) field_buffer() noexcept
+    {
+        return kf_.member();
+    }
+
+    decltype(auto) field_buffer() const noexcept
     {
-        return nf_.member();
+        return kf_.member();
     }
 
-    decltype(auto) record_buffer()
+    std::vector<Ch, alloc_t>& record_buffer() noexcept
     {
-        return vr_.member();
+        return record_buffer_;
     }
 
     template <class F>
@@ -435,7 +694,7 @@ private:
         } else {
             b.insert(b.cend(), first, last);
             const auto r = f(std::basic_string_view<Ch, Tr>(
-            	                b.data(), b.size()));
+                                b.data(), b.size()));
             b.clear();
             return r;
         }
@@ -448,8 +707,7 @@ private:
         try {
             std::ostringstream what;
             what << what_core;
-            write_formatted_field_name_of<Tr>(what, " for "sv, nf_.base(),
-                static_cast<const Ch*>(nullptr));
+            keys().write_unresolved(what, " for "sv);
             return record_extraction_error(std::move(what).str());
         } catch (...) {
             return record_extraction_error(what_core);
@@ -473,8 +731,7 @@ private:
         switch (record_mode_) {
         case record_mode::include:
             flush_record_buffer();
-            flush_current(record_end);
-            flush_lf();
+            append_to_run(record_end);
             record_mode_ = record_mode::exclude;    // to prevent end_buffer
                                                     // from doing anything
             return true;
@@ -492,6 +749,38 @@ private:
         }
     }
 
+    // Included records which are adjacent and separated by single line
+    // feeds are written in one go, which lets the stream buffer pass long
+    // runs on to the sink without copying them to its own buffer
+    void append_to_run(const Ch* record_end)
+    {
+        if (run_begin_ && (current_begin_ == run_end_ + 1)
+         && Tr::eq(*run_end_, key_chars<Ch>::lf_c)) {
+            run_end_ = record_end;
+        } else {
+            flush_run(current_begin_);
+            run_begin_ = current_begin_;
+            run_end_ = record_end;
+        }
+    }
+
+    // The terminator of the last record in the run is written together if
+    // it is a line feed and in [run_end_, readable_end)
+    void flush_run(const Ch* readable_end)
+    {
+        if (const auto b = std::exchange(run_begin_, nullptr)) {
+            if (out_) {
+                if ((run_end_ < readable_end)
+                 && Tr::eq(*run_end_, key_chars<Ch>::lf_c)) {
+                    out_->sputn(b, (run_end_ + 1) - b);
+                } else {
+                    out_->sputn(b, run_end_ - b);
+                    flush_lf();
+                }
+            }
+        }
+    }
+
     void flush_record_buffer()
     {
         if (out_ && !record_buffer().empty()) {
@@ -536,6 +825,24 @@ template <class T, class Ch, class Tr>
 constexpr bool is_string_pred_v = decltype(is_string_pred_impl<Ch, Tr>::
                                     template check<T>(nullptr))::value;
 
+template <class Keys, class Ch, class Tr>
+struct are_string_pred_pairs :
+    std::false_type
+{};
+
+template <class... FieldNamePreds, class... FieldValuePreds,
+          class Ch, class Tr>
+struct are_string_pred_pairs<
+        std::tuple<std::pair<FieldNamePreds, FieldValuePreds>...>, Ch, Tr> :
+    std::bool_constant<(sizeof...(FieldNamePreds) > 0)
+                    && (is_string_pred_v<FieldNamePreds, Ch, Tr> && ...)
+                    && (is_string_pred_v<FieldValuePreds, Ch, Tr> && ...)>
+{};
+
+template <class Keys, class Ch, class Tr>
+constexpr bool are_string_pred_pairs_v =
+    are_string_pred_pairs<Keys, Ch, Tr>::value;
+
 } // end detail::record_extraction
 
 enum class header_forwarding : std::uint_fast8_t
@@ -547,7 +854,9 @@ template <class FieldNamePred, class FieldValuePred, class Ch,
     class Tr = std::char_traits<Ch>, class Allocator = std::allocator<Ch>>
 class record_extractor :
     public detail::record_extraction::impl<
-        FieldNamePred, FieldValuePred, Ch, Tr, Allocator>
+        detail::record_extraction::single_key<
+            FieldNamePred, FieldValuePred, Ch, Tr>,
+        Ch, Tr, Allocator>
 {
     static_assert(detail::record_extraction::
                     is_string_pred_v<FieldNamePred, Ch, Tr>,
@@ -556,8 +865,9 @@ class record_extractor :
                     is_string_pred_v<FieldValuePred, Ch, Tr>,
         "FieldValuePred of record_extractor is not a valid invocable type");
 
-    using base = detail::record_extraction::impl<
-        FieldNamePred, FieldValuePred, Ch, Tr, Allocator>;
+    using keys_t = detail::record_extraction::single_key<
+        FieldNamePred, FieldValuePred, Ch, Tr>;
+    using base = detail::record_extraction::impl<keys_t, Ch, Tr, Allocator>;
 
 public:
     template <class FieldNamePredR, class FieldValuePredR,
@@ -589,9 +899,10 @@ public:
         header_forwarding header = header_forwarding::yes,
         std::size_t max_record_num = 0) :
         base(std::allocator_arg, alloc, out,
-            std::forward<FieldNamePredR>(field_name_pred),
-            std::forward<FieldValuePredR>(field_value_pred),
-            (header == header_forwarding::yes), max_record_num)
+            keys_t(std::forward<FieldNamePredR>(field_name_pred),
+                   std::forward<FieldValuePredR>(field_value_pred),
+                   record_extractor_npos),
+            true, (header == header_forwarding::yes), max_record_num)
     {}
 
     record_extractor(record_extractor&&) = default;
@@ -615,7 +926,9 @@ template <class FieldValuePred, class Ch,
     class Tr = std::char_traits<Ch>, class Allocator = std::allocator<Ch>>
 class record_extractor_with_indexed_key :
     public detail::record_extraction::impl<
-        detail::record_extraction::hollow_field_name_pred, FieldValuePred,
+        detail::record_extraction::single_key<
+            detail::record_extraction::hollow_field_name_pred, FieldValuePred,
+            Ch, Tr>,
         Ch, Tr, Allocator>
 {
     static_assert(detail::record_extraction::
@@ -623,9 +936,10 @@ class record_extractor_with_indexed_key :
         "FieldValuePred of record_extractor_with_indexed_key "
         "is not a valid invocable type");
 
-    using base = detail::record_extraction::impl<
+    using keys_t = detail::record_extraction::single_key<
         detail::record_extraction::hollow_field_name_pred, FieldValuePred,
-        Ch, Tr, Allocator>;
+        Ch, Tr>;
+    using base = detail::record_extraction::impl<keys_t, Ch, Tr, Allocator>;
 
 public:
     template <class FieldValuePredR,
@@ -655,8 +969,9 @@ public:
         std::size_t max_record_num = 0) :
         base(
             std::allocator_arg, alloc, out,
-            sanitize_target_field_index(target_field_index),
-            std::forward<FieldValuePredR>(field_value_pred),
+            keys_t(detail::record_extraction::hollow_field_name_pred(),
+                   std::forward<FieldValuePredR>(field_value_pred),
+                   sanitize_target_field_index(target_field_index)),
             (header.has_value()),
             (header.has_value() && (*header == header_forwarding::yes)),
             max_record_num)
@@ -691,6 +1006,61 @@ record_extractor_with_indexed_key(std::allocator_arg_t, Allocator,
     std::basic_streambuf<Ch, Tr>&, std::size_t, FieldValuePred, Args...)
  -> record_extractor_with_indexed_key<FieldValuePred, Ch, Tr, Allocator>;
 
+template <class Keys, class Ch,
+    class Tr = std::char_traits<Ch>, class Allocator = std::allocator<Ch>>
+class multi_record_extractor :
+    public detail::record_extraction::impl<
+        detail::record_extraction::multiple_keys<Keys, Ch, Tr>,
+        Ch, Tr, Allocator>
+{
+    static_assert(detail::record_extraction::
+                    are_string_pred_pairs_v<Keys, Ch, Tr>,
+        "Keys of multi_record_extractor is not a nonempty tuple of pairs of "
+        "valid invocable types");
+
+    using keys_t = detail::record_extraction::multiple_keys<Keys, Ch, Tr>;
+    using base = detail::record_extraction::impl<keys_t, Ch, Tr, Allocator>;
+
+public:
+    template <class KeysR,
+        std::enable_if_t<std::is_constructible_v<Keys, KeysR&&>>* = nullptr>
+    multi_record_extractor(
+        std::basic_streambuf<Ch, Tr>& out,
+        key_combination combination, KeysR&& keys,
+        header_forwarding header = header_forwarding::yes,
+        std::size_t max_record_num = 0) :
+        multi_record_extractor(
+            std::allocator_arg, Allocator(), out, combination,
+            std::forward<KeysR>(keys), header, max_record_num)
+    {}
+
+    template <class KeysR,
+        std::enable_if_t<std::is_constructible_v<Keys, KeysR&&>>* = nullptr>
+    multi_record_extractor(
+        std::allocator_arg_t, const Allocator& alloc,
+        std::basic_streambuf<Ch, Tr>& out,
+        key_combination combination, KeysR&& keys,
+        header_forwarding header = header_forwarding::yes,
+        std::size_t max_record_num = 0) :
+        base(std::allocator_arg, alloc, out,
+            keys_t(combination, std::forward<KeysR>(keys)),
+            true, (header == header_forwarding::yes), max_record_num)
+    {}
+
+    multi_record_extractor(multi_record_extractor&&) = default;
+    ~multi_record_extractor() = default;
+};
+
+template <class Keys, class Ch, class Tr, class... Args>
+multi_record_extractor(std::basic_streambuf<Ch, Tr>&, key_combination, Keys,
+    Args...)
+ -> multi_record_extractor<Keys, Ch, Tr, std::allocator<Ch>>;
+
+template <class Keys, class Ch, class Tr, class Allocator, class... Args>
+multi_record_extractor(std::allocator_arg_t, Allocator,
+    std::basic_streambuf<Ch, Tr>&, key_combination, Keys, Args...)
+ -> multi_record_extractor<Keys, Ch, Tr, Allocator>;
+
 namespace detail::record_extraction {
 
 template <class Ch, class Tr, class T>
@@ -776,6 +1146,52 @@ template <class Ch, class Tr, class... Appendices>
         out, std::forward<Appendices>(appendices)...);
 }
 
+namespace detail::record_extraction {
+
+template <class Ch, class Tr, class FieldNamePred, class FieldValuePred>
+auto make_string_pred_pair(std::pair<FieldNamePred, FieldValuePred>&& key)
+{
+    return std::pair<
+        std::decay_t<decltype(make_string_pred<Ch, Tr>(
+            std::declval<FieldNamePred>()))>,
+        std::decay_t<decltype(make_string_pred<Ch, Tr>(
+            std::declval<FieldValuePred>()))>>(
+        make_string_pred<Ch, Tr>(std::forward<FieldNamePred>(key.first)),
+        make_string_pred<Ch, Tr>(std::forward<FieldValuePred>(key.second)));
+}
+
+} // end detail::record_extraction
+
+template <class... FieldNamePreds, class... FieldValuePreds,
+    class Ch, class Tr, class Allocator, class... Appendices>
+[[nodiscard]] auto make_multi_record_extractor(
+    std::allocator_arg_t, const Allocator& alloc,
+    std::basic_streambuf<Ch, Tr>& out, key_combination combination,
+    std::tuple<std::pair<FieldNamePreds, FieldValuePreds>...> keys,
+    Appendices&&... appendices)
+{
+    return multi_record_extractor(
+        std::allocator_arg, alloc, out, combination,
+        std::apply([](auto&&... ks) {
+            return std::make_tuple(
+                detail::record_extraction::make_string_pred_pair<Ch, Tr>(
+                    std::move(ks))...);
+        }, std::move(keys)),
+        std::forward<Appendices>(appendices)...);
+}
+
+template <class Ch, class Tr, class... FieldNamePreds,
+    class... FieldValuePreds, class... Appendices>
+[[nodiscard]] auto make_multi_record_extractor(
+    std::basic_streambuf<Ch, Tr>& out, key_combination combination,
+    std::tuple<std::pair<FieldNamePreds, FieldValuePreds>...> keys,
+    Appendices&&... appendices)
+{
+    return make_multi_record_extractor(
+        std::allocator_arg, std::allocator<Ch>(), out, combination,
+        std::move(keys), std::forward<Appendices>(appendices)...);
+}
+
 }
 
 #endif
@@ -0,0 +1,386 @@
+/**
+ * These codes are licensed under the Unlicense.
+ * http://unlicense.org
+ */
+
+#ifndef COMMATA_GUARD_6514F023_84D6_403C_B62B_2BC750C00626
+#define COMMATA_GUARD_6514F023_84D6_403C_B62B_2BC750C00626
+
+#if __has_include(<version>)
+#include <version>
+#endif
+
+#ifdef __cpp_lib_coroutine
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "table_pull.hpp"
+#include "wrapper_handlers.hpp"
+
+namespace commata {
+
+namespace detail::records {
+
+// A table handler which stores each record and has the parser suspended
+// only at its end
+template <class Ch, class Tr, class Allocator>
+class handler
+{
+public:
+    using char_type = const Ch;
+
+private:
+    pull::record_store<const Ch, Tr, Allocator> record_;
+    bool record_ends_;
+    bool eof_;
+    std::size_t yield_location_;
+
+public:
+    explicit handler(const Allocator& alloc) :
+        record_(alloc), record_ends_(false), eof_(false), yield_location_(0)
+    {}
+
+    handler(const handler&) = delete;
+    handler(handler&&) = delete;
+    ~handler() = default;
+
+    void start_buffer(const Ch* /*buffer_begin*/, const Ch* /*buffer_end*/)
+    {}
+
+    void end_buffer(const Ch* /*buffer_end*/)
+    {
+        // A record which has ended at the EOF is handed out before the
+        // buffer is released, so it can stay there; evacuating it would
+        // invalidate the views made by end_record
+        if (!record_ends_) {
+            record_.evacuate();                                     // throw
+        }
+    }
+
+    void start_record(const Ch* /*record_begin*/)
+    {}
+
+    void update(const Ch* first, const Ch* last)
+    {
+        record_.update(first, last);                                // throw
+    }
+
+    void finalize(const Ch* first, const Ch* last)
+    {
+        record_.finalize(first, last);                              // throw
+    }
+
+    void end_record(const Ch* /*record_end*/)
+    {
+        record_.seal();                                             // throw
+        record_ends_ = true;
+    }
+
+    void empty_physical_line(const Ch* /*where*/)
+    {}
+
+    bool yield(std::size_t location) noexcept
+    {
+        if (location == static_cast<std::size_t>(-1)) {
+            eof_ = true;
+        } else if (!record_ends_) {
+            return false;
+        }
+        yield_location_ = location;
+        return true;
+    }
+
+    std::size_t yield_location() const noexcept
+    {
+        return yield_location_;
+    }
+
+    bool has_record() const noexcept
+    {
+        return record_ends_;
+    }
+
+    bool is_eof() const noexcept
+    {
+        return eof_;
+    }
+
+    auto record() const noexcept
+    {
+        return record_.view();
+    }
+
+    void clear_record() noexcept
+    {
+        record_.clear();
+        record_ends_ = false;
+    }
+};
+
+// Allocates coroutine frames with an allocator, which is put after the
+// frame to be picked up on deallocation
+template <class Allocator>
+class frame_allocation
+{
+    struct alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) block
+    {
+        char bytes[__STDCPP_DEFAULT_NEW_ALIGNMENT__];
+    };
+
+    using at_t = std::allocator_traits<Allocator>;
+    using block_a_t = typename at_t::template rebind_alloc<block>;
+    using block_at_t = std::allocator_traits<block_a_t>;
+
+    static std::size_t allocator_offset(std::size_t frame_size) noexcept
+    {
+        constexpr auto a = alignof(block_a_t);
+        return (frame_size + a - 1) / a * a;
+    }
+
+    static std::size_t block_count(std::size_t frame_size) noexcept
+    {
+        const auto n = allocator_offset(frame_size) + sizeof(block_a_t);
+        return (n + sizeof(block) - 1) / sizeof(block);
+    }
+
+public:
+    static void* allocate(std::size_t frame_size, const Allocator& alloc)
+    {
+        block_a_t a(alloc);
+        const auto p = std::to_address(
+            block_at_t::allocate(a, block_count(frame_size)));      // throw
+        const auto q = reinterpret_cast<char*>(p);
+        ::new(q + allocator_offset(frame_size)) block_a_t(std::move(a));
+        return q;
+    }
+
+    static void deallocate(void* frame, std::size_t frame_size) noexcept
+    {
+        const auto q = static_cast<char*>(frame);
+        const auto pa = std::launder(reinterpret_cast<block_a_t*>(
+            q + allocator_offset(frame_size)));
+        block_a_t a(std::move(*pa));
+        pa->~block_a_t();
+        block_at_t::deallocate(a,
+            std::pointer_traits<typename block_at_t::pointer>::pointer_to(
+                *reinterpret_cast<block*>(q)),
+            block_count(frame_size));
+    }
+};
+
+} // end detail::records
+
+template <class Ch, class Tr = std::char_traits<Ch>,
+          class Allocator = std::allocator<Ch>>
+class record_generator
+{
+public:
+    using char_type = Ch;
+    using traits_type = Tr;
+    using allocator_type = Allocator;
+    using view_type = std::basic_string_view<Ch, Tr>;
+    using value_type = detail::pull::record_view<view_type>;
+
+    class promise_type
+    {
+        const value_type* current_ = nullptr;
+        std::exception_ptr exception_;
+
+        friend class record_generator;
+
+    public:
+        record_generator get_return_object() noexcept
+        {
+            return record_generator(
+                std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() const noexcept
+        {
+            return {};
+        }
+
+        std::suspend_always final_suspend() const noexcept
+        {
+            return {};
+        }
+
+        std::suspend_always yield_value(const value_type& value) noexcept
+        {
+            current_ = std::addressof(value);
+            return {};
+        }
+
+        void return_void() const noexcept
+        {}
+
+        void unhandled_exception() noexcept
+        {
+            exception_ = std::current_exception();
+        }
+
+        template <class... Args>
+        static void* operator new(std::size_t size,
+            std::allocator_arg_t, const Allocator& alloc, const Args&...)
+        {
+            return detail::records::frame_allocation<Allocator>::
+                allocate(size, alloc);                              // throw
+        }
+
+        static void operator delete(void* p, std::size_t size) noexcept
+        {
+            detail::records::frame_allocation<Allocator>::deallocate(p, size);
+        }
+    };
+
+    class iterator
+    {
+        std::coroutine_handle<promise_type> h_;
+
+    public:
+        using value_type = typename record_generator::value_type;
+        using difference_type = std::ptrdiff_t;
+        using reference = const value_type&;
+        using pointer = const value_type*;
+        using iterator_category = std::input_iterator_tag;
+
+        iterator() noexcept = default;
+
+        explicit iterator(std::coroutine_handle<promise_type> h) noexcept :
+            h_(h)
+        {}
+
+        reference operator*() const noexcept
+        {
+            return *h_.promise().current_;
+        }
+
+        pointer operator->() const noexcept
+        {
+            return h_.promise().current_;
+        }
+
+        iterator& operator++()
+        {
+            resume(h_);                                             // throw
+            return *this;
+        }
+
+        void operator++(int)
+        {
+            ++*this;                                                // throw
+        }
+
+        friend bool operator==(const iterator& i, std::default_sentinel_t)
+            noexcept
+        {
+            return i.h_.done();
+        }
+    };
+
+private:
+    std::coroutine_handle<promise_type> h_;
+
+    explicit record_generator(std::coroutine_handle<promise_type> h)
+        noexcept :
+        h_(h)
+    {}
+
+    static void resume(std::coroutine_handle<promise_type> h)
+    {
+        h.resume();
+        if (auto& e = h.promise().exception_) {
+            std::rethrow_exception(std::exchange(e, nullptr));      // throw
+        }
+    }
+
+public:
+    record_generator(record_generator&& other) noexcept :
+        h_(std::exchange(other.h_, nullptr))
+    {}
+
+    ~record_generator()
+    {
+        if (h_) {
+            h_.destroy();
+        }
+    }
+
+    record_generator& operator=(record_generator&& other) noexcept
+    {
+        if (this != std::addressof(other)) {
+            if (h_) {
+                h_.destroy();
+            }
+            h_ = std::exchange(other.h_, nullptr);
+        }
+        return *this;
+    }
+
+    iterator begin()
+    {
+        resume(h_);                                                 // throw
+        return iterator(h_);
+    }
+
+    std::default_sentinel_t end() const noexcept
+    {
+        return std::default_sentinel;
+    }
+};
+
+// GCC takes the frame allocation with an allocator for a mismatch
+#if defined(__GNUC__) && !defined(__clang__) && (__GNUC__ >= 11)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+template <class TableSource, class Allocator>
+[[nodiscard]] record_generator<typename TableSource::char_type,
+                               typename TableSource::traits_type, Allocator>
+    records(std::allocator_arg_t, Allocator alloc, TableSource in,
+            std::size_t buffer_size = 0)
+{
+    detail::records::handler<typename TableSource::char_type,
+        typename TableSource::traits_type, Allocator> h(alloc);
+    auto p = std::move(in)(wrap_ref(h), buffer_size, alloc);        // throw
+
+    // The parser is resumed once for each record
+    for (;;) {
+        p();                                                        // throw
+        if (h.has_record()) {
+            co_yield h.record();
+            h.clear_record();
+        } else if (h.is_eof()) {
+            break;
+        }
+    }
+}
+#if defined(__GNUC__) && !defined(__clang__) && (__GNUC__ >= 11)
+#pragma GCC diagnostic pop
+#endif
+
+template <class TableSource,
+    std::enable_if_t<
+        !std::is_same_v<std::decay_t<TableSource>, std::allocator_arg_t>>*
+    = nullptr>
+[[nodiscard]] auto records(TableSource&& in, std::size_t buffer_size = 0)
+{
+    return records(std::allocator_arg,
+        std::allocator<typename std::decay_t<TableSource>::char_type>(),
+        std::decay_t<TableSource>(std::forward<TableSource>(in)),
+        buffer_size);
+}
+
+}
+
+#endif
+
+#endif
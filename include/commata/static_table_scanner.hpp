@@ -0,0 +1,324 @@
+/**
+ * These codes are licensed under the Unlicense.
+ * http://unlicense.org
+ */
+
+#ifndef COMMATA_GUARD_03765A42_0313_4BD3_902D_C125427883BD
+#define COMMATA_GUARD_03765A42_0313_4BD3_902D_C125427883BD
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace commata {
+
+// A table scanner whose body field scanners are fixed at compile time; the
+// J-th element of FieldScanners scans the J-th field, or nothing when it is
+// std::nullptr_t, and the fields beyond them are ignored
+template <class Ch, class Tr, class Allocator, class... FieldScanners>
+class basic_static_table_scanner
+{
+    using string_t = std::basic_string<Ch, Tr, Allocator>;
+
+    static constexpr std::size_t field_scanner_count =
+        sizeof...(FieldScanners);
+
+    // The last elements are only to avoid zero-sized arrays
+    static constexpr bool has_field_scanner_a[] = {
+        !std::is_same_v<FieldScanners, std::nullptr_t>..., false
+    };
+    static constexpr bool accepts_const_a[] = {
+        std::is_invocable_v<FieldScanners&, const Ch*, const Ch*>..., false
+    };
+
+    static_assert(((std::is_same_v<FieldScanners, std::nullptr_t>
+                 || std::is_invocable_v<FieldScanners&, Ch*, Ch*>
+                 || std::is_invocable_v<FieldScanners&, string_t&&>) && ...),
+        "Each field scanner shall accept a range of chars or a string");
+
+    std::tuple<FieldScanners...> scanners_;
+    std::size_t remaining_header_records_;
+    std::size_t j_;
+    const Ch* begin_;
+    const Ch* end_;
+    string_t value_;
+
+public:
+    using char_type = const Ch;
+    using traits_type = Tr;
+    using allocator_type = Allocator;
+    using size_type = typename std::allocator_traits<Allocator>::size_type;
+
+    template <class... FieldScannersR,
+        std::enable_if_t<
+            (sizeof...(FieldScannersR) == sizeof...(FieldScanners))
+         && std::is_constructible_v<std::tuple<FieldScanners...>,
+                                    FieldScannersR&&...>>* = nullptr>
+    explicit basic_static_table_scanner(std::size_t header_record_count,
+        FieldScannersR&&... scanners) :
+        basic_static_table_scanner(std::allocator_arg, Allocator(),
+            header_record_count, std::forward<FieldScannersR>(scanners)...)
+    {}
+
+    template <class... FieldScannersR,
+        std::enable_if_t<
+            (sizeof...(FieldScannersR) == sizeof...(FieldScanners))
+         && std::is_constructible_v<std::tuple<FieldScanners...>,
+                                    FieldScannersR&&...>>* = nullptr>
+    basic_static_table_scanner(std::allocator_arg_t, const Allocator& alloc,
+        std::size_t header_record_count, FieldScannersR&&... scanners) :
+        scanners_(std::forward<FieldScannersR>(scanners)...),
+        remaining_header_records_(header_record_count), j_(0),
+        begin_(nullptr), end_(nullptr), value_(alloc)
+    {}
+
+    basic_static_table_scanner(basic_static_table_scanner&&) = default;
+    ~basic_static_table_scanner() = default;
+
+    allocator_type get_allocator() const noexcept
+    {
+        return value_.get_allocator();
+    }
+
+    template <std::size_t J>
+    decltype(auto) get_field_scanner() noexcept
+    {
+        return std::get<J>(scanners_);
+    }
+
+    template <std::size_t J>
+    decltype(auto) get_field_scanner() const noexcept
+    {
+        return std::get<J>(scanners_);
+    }
+
+    bool is_in_header() const noexcept
+    {
+        return remaining_header_records_ > 0;
+    }
+
+    void start_buffer(const Ch* /*buffer_begin*/, const Ch* /*buffer_end*/)
+    {}
+
+    void end_buffer(const Ch* /*buffer_end*/)
+    {
+        if (begin_) {
+            value_.assign(begin_, end_);                // throw
+            begin_ = nullptr;
+        }
+    }
+
+    void start_record(const Ch* /*record_begin*/)
+    {
+        j_ = 0;
+    }
+
+    void update(Ch* first, Ch* last)
+    {
+        update_impl(first, last);
+    }
+
+    void update(const Ch* first, const Ch* last)
+    {
+        update_impl(first, last);
+    }
+
+    void finalize(Ch* first, Ch* last)
+    {
+        finalize_impl(first, last);
+    }
+
+    void finalize(const Ch* first, const Ch* last)
+    {
+        finalize_impl(first, last);
+    }
+
+    bool end_record(const Ch* /*record_end*/)
+    {
+        if (is_in_header()) {
+            --remaining_header_records_;
+        } else {
+            skip_fields(std::index_sequence_for<FieldScanners...>());
+        }
+        return true;
+    }
+
+private:
+    bool is_active() const noexcept
+    {
+        return (j_ < field_scanner_count) && has_field_scanner_a[j_]
+            && !is_in_header();
+    }
+
+    template <class C>
+    void update_impl(C* first, C* last)
+    {
+        if (!is_active()) {
+            return;
+        }
+        if constexpr (std::is_const_v<C>) {
+            if (!accepts_const_a[j_]) {
+                value_.append(first, last);                         // throw
+                return;
+            }
+        }
+        if (!value_.empty()) {
+            value_.append(first, last);                             // throw
+        } else if (begin_) {
+            value_.reserve((end_ - begin_) + (last - first));       // throw
+            value_.assign(begin_, end_);
+            value_.append(first, last);
+            begin_ = nullptr;
+        } else {
+            begin_ = first;
+            end_ = last;
+        }
+    }
+
+    template <class C>
+    void finalize_impl(C* first, C* last)
+    {
+        if (is_active()) {
+            finalize_core(first, last);
+        }
+        ++j_;
+    }
+
+    template <class C>
+    void finalize_core(C* first, C* last)
+    {
+        if constexpr (std::is_const_v<C>) {
+            if (!accepts_const_a[j_]) {
+                finalize_core_with_value(first, last);              // throw
+                return;
+            }
+        }
+        if (!value_.empty()) {
+            finalize_core_with_value(first, last);                  // throw
+        } else if (begin_) {
+            if (first != last) {
+                value_.reserve((end_ - begin_) + (last - first));   // throw
+                value_.assign(begin_, end_);
+                finalize_core_with_value(first, last);              // throw
+            } else if constexpr (std::is_const_v<C>) {
+                field_value(begin_, end_);
+            } else {
+                // Here we know it is the non-const version that is being
+                // called, so const_casts below are safe
+                field_value(const_cast<Ch*>(begin_), const_cast<Ch*>(end_));
+            }
+            begin_ = nullptr;
+        } else {
+            field_value(first, last);
+        }
+    }
+
+    template <class C>
+    void finalize_core_with_value(C* first, C* last)
+    {
+        value_.append(first, last);                                 // throw
+        visit([this](auto& scanner) {
+            using scanner_t = std::remove_reference_t<decltype(scanner)>;
+            if constexpr (std::is_invocable_v<scanner_t&, string_t&&>) {
+                scanner(std::move(value_));
+            } else {
+                scanner(value_.data(), value_.data() + value_.size());
+            }
+        });
+        value_.clear();
+    }
+
+    template <class C>
+    void field_value(C* begin, C* end)
+    {
+        visit([this, begin, end](auto& scanner) {
+            using scanner_t = std::remove_reference_t<decltype(scanner)>;
+            // Even when the scanner accepts non-const params only, this will
+            // be instantiated with C being const, which will never be called
+            // at run-time, so this branching is needed; scanners accepting
+            // neither form are rejected at the class level
+            if constexpr (std::is_invocable_v<scanner_t&, C*, C*>) {
+                scanner(begin, end);
+            } else if constexpr (std::is_invocable_v<scanner_t&, string_t>) {
+                scanner(string_t(begin, end, get_allocator()));
+            }
+        });
+    }
+
+    // Calls f with the field scanner for the current field, which shall not
+    // be std::nullptr_t; compilers are expected to turn the fold below into
+    // a switch statement
+    template <class F>
+    void visit(F f)
+    {
+        visit_impl(f, std::index_sequence_for<FieldScanners...>());
+    }
+
+    template <class F, std::size_t... Js>
+    void visit_impl(F& f, std::index_sequence<Js...>)
+    {
+        (void) ((j_ == Js ? (visit_one<Js>(f), true) : false) || ...);
+    }
+
+    template <std::size_t J, class F>
+    void visit_one(F& f)
+    {
+        if constexpr (has_field_scanner_a[J]) {
+            f(std::get<J>(scanners_));
+        }
+    }
+
+    template <std::size_t... Js>
+    void skip_fields(std::index_sequence<Js...>)
+    {
+        (skip_field<Js>(), ...);
+    }
+
+    template <std::size_t J>
+    void skip_field()
+    {
+        if constexpr (has_field_scanner_a[J]) {
+            if (J >= j_) {
+                std::get<J>(scanners_)();
+            }
+        }
+    }
+};
+
+template <class... FieldScanners>
+using static_table_scanner = basic_static_table_scanner<
+    char, std::char_traits<char>, std::allocator<char>, FieldScanners...>;
+
+template <class... FieldScanners>
+using wstatic_table_scanner = basic_static_table_scanner<
+    wchar_t, std::char_traits<wchar_t>, std::allocator<wchar_t>,
+    FieldScanners...>;
+
+template <class Ch, class Tr = std::char_traits<Ch>,
+          class Allocator = std::allocator<Ch>, class... FieldScanners>
+[[nodiscard]] auto make_static_table_scanner(
+    std::size_t header_record_count, FieldScanners&&... scanners)
+{
+    return basic_static_table_scanner<
+            Ch, Tr, Allocator, std::decay_t<FieldScanners>...>(
+        header_record_count, std::forward<FieldScanners>(scanners)...);
+}
+
+template <class Ch, class Tr = std::char_traits<Ch>,
+          class Allocator, class... FieldScanners>
+[[nodiscard]] auto make_static_table_scanner(
+    std::allocator_arg_t, const Allocator& alloc,
+    std::size_t header_record_count, FieldScanners&&... scanners)
+{
+    return basic_static_table_scanner<
+            Ch, Tr, Allocator, std::decay_t<FieldScanners>...>(
+        std::allocator_arg, alloc,
+        header_record_count, std::forward<FieldScanners>(scanners)...);
+}
+
+}
+
+#endif
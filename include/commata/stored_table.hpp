@@ -12,6 +12,7 @@
 #include <cstdint>
 #include <deque>
 #include <functional>
+#include <initializer_list>
 #include <iterator>
 #include <limits>
 #include <list>
@@ -24,15 +25,19 @@
 #include <string_view>
 #include <tuple>
 #include <type_traits>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
+#include "text_error.hpp"
+
 #include "detail/buffer_size.hpp"
 #include "detail/member_like_base.hpp"
 #include "detail/propagation_controlled_allocator.hpp"
 #include "detail/string_value.hpp"
 #include "detail/typing_aid.hpp"
+#include "detail/write_ntmbs.hpp"
 
 namespace commata {
 
@@ -685,12 +690,17 @@ public:
         hwl_ = buffer_;
     }
 
-    bool is_cleared() noexcept
+    bool is_cleared() const noexcept
     {
         return buffer_ == hwl_;
     }
 
-    std::size_t size() noexcept
+    Ch* buffer() const noexcept
+    {
+        return buffer_;
+    }
+
+    std::size_t size() const noexcept
     {
         return end_ - buffer_;
     }
@@ -949,20 +959,69 @@ public:
     {
         assert(get_allocator() == other.get_allocator());
 
-        *(buffers_back_ ? &buffers_back_->next : &buffers_) =
-            std::exchange(other.buffers_, nullptr);
-        buffers_back_ = std::exchange(other.buffers_back_, nullptr);
-        buffers_size_ += std::exchange(other.buffers_size_, 0);
+        // Our backs must be kept if other's lists are empty
+        if (other.buffers_) {
+            *(buffers_back_ ? &buffers_back_->next : &buffers_) =
+                std::exchange(other.buffers_, nullptr);
+            buffers_back_ = std::exchange(other.buffers_back_, nullptr);
+            buffers_size_ += std::exchange(other.buffers_size_, 0);
+        }
 
-        *(buffers_cleared_back_ ?
-                &buffers_cleared_back_->next : &buffers_cleared_) =
-            std::exchange(other.buffers_cleared_, nullptr);
-        buffers_cleared_back_ =
-            std::exchange(other.buffers_cleared_back_, nullptr);
+        if (other.buffers_cleared_) {
+            *(buffers_cleared_back_ ?
+                    &buffers_cleared_back_->next : &buffers_cleared_) =
+                std::exchange(other.buffers_cleared_, nullptr);
+            buffers_cleared_back_ =
+                std::exchange(other.buffers_cleared_back_, nullptr);
+        }
 
         return *this;
     }
 
+    // Returns the total length of all buffers including cleared ones
+    std::size_t get_total_size() const noexcept
+    {
+        std::size_t n = 0;
+        for (auto i = buffers_; i; i = i->next) {
+            n += i->size();
+        }
+        for (auto i = buffers_cleared_; i; i = i->next) {
+            n += i->size();
+        }
+        return n;
+    }
+
+    // Returns {total size of buffers, total size of secured elements, total
+    // size of cleared buffers, number of buffers} in elements
+    std::tuple<std::size_t, std::size_t, std::size_t, std::size_t>
+        get_usage() const noexcept
+    {
+        std::size_t total = 0;
+        std::size_t secured = 0;
+        std::size_t cleared = 0;
+        std::size_t count = 0;
+        for (auto i = buffers_; i; i = i->next) {
+            total += i->size();
+            secured += i->secured() - i->buffer();
+            ++count;
+        }
+        for (auto i = buffers_cleared_; i; i = i->next) {
+            total += i->size();
+            cleared += i->size();
+            ++count;
+        }
+        return { total, secured, cleared, count };
+    }
+
+    // Calls f(first, secured_last) for each of buffers not cleared
+    template <class F>
+    void for_each_secured(F f) const
+    {
+        for (auto i = buffers_; i; i = i->next) {
+            f(i->buffer(), i->secured());
+        }
+    }
+
     security get_security() const
     {
         security s;                         // throw
@@ -1106,6 +1165,19 @@ template <class Container>
 static void reserve(Container&, typename Container::size_type)
 {}
 
+// Estimated number of bytes occupied by the elements of a container
+template <class Container>
+std::size_t element_footprint(const Container& c) noexcept
+{
+    return c.size() * sizeof(typename Container::value_type);
+}
+
+template <class... Ts>
+std::size_t element_footprint(const std::vector<Ts...>& c) noexcept
+{
+    return c.capacity() * sizeof(typename std::vector<Ts...>::value_type);
+}
+
 template <class... Ts>
 static void reserve(std::vector<Ts...>& c,
     typename std::vector<Ts...>::size_type n)
@@ -1115,6 +1187,18 @@ static void reserve(std::vector<Ts...>& c,
 
 } // end detail::stored
 
+template <class Content, class Allocator>
+class stored_table_compactor;
+
+struct stored_table_memory_usage
+{
+    std::size_t allocated;      // bytes of all buffers in the store
+    std::size_t secured;        // bytes reserved for values in the buffers
+    std::size_t cleared;        // bytes of the buffers waiting for reuse
+    std::size_t buffer_count;   // number of buffers including cleared ones
+    std::size_t content;        // estimated bytes of the content container
+};
+
 template <class Content, class Allocator = std::allocator<Content>>
 class basic_stored_table
 {
@@ -1151,6 +1235,8 @@ private:
     template <class OtherContent, class OtherAllocator>
     friend class basic_stored_table;
 
+    friend class stored_table_compactor<Content, Allocator>;
+
 private:
     store_type store_;
     typename at_t::pointer records_;
@@ -1546,6 +1632,127 @@ public:
         basic_stored_table(*this).swap(*this);     // throw
     }
 
+    std::size_t compact()
+    {
+        const auto before = store_.get_total_size();
+        store_type s(std::allocator_arg, store_.get_allocator());
+        if (records_) {
+            compact_into(s);                        // throw
+        }
+        store_.swap_force(s);
+        const auto after = store_.get_total_size();
+        return (before > after) ? (before - after) * sizeof(char_type) : 0;
+    }
+
+    stored_table_memory_usage memory_usage() const noexcept
+    {
+        stored_table_memory_usage u;
+        std::tie(u.allocated, u.secured, u.cleared, u.buffer_count) =
+            store_.get_usage();
+        u.allocated *= sizeof(char_type);
+        u.secured *= sizeof(char_type);
+        u.cleared *= sizeof(char_type);
+        u.content = 0;
+        if (records_ && !content().empty()) {
+            u.content = sizeof(content_type)
+                      + detail::stored::element_footprint(content());
+            for (const auto& r : content()) {
+                u.content += detail::stored::element_footprint(r);
+            }
+        }
+        return u;
+    }
+
+private:
+    // Copies all contained values into one freshly allocated buffer of "s"
+    // in record order and then makes them backed by it; if an exception is
+    // thrown, no contained values are modified
+    void compact_into(store_type& s)
+    {
+        if constexpr (shares_buffers) {
+            using va_t = typename at_t::template
+                rebind_alloc<std::pair<const value_type, value_type>>;
+            using canon_t = std::unordered_map<value_type, value_type,
+                std::hash<value_type>, std::equal_to<value_type>, va_t>;
+
+            canon_t canonicals(va_t{get_allocator()});              // throw
+            std::size_t total = 0;
+            for (const auto& r : content()) {
+                for (const auto& v : r) {
+                    if (!v.empty() && canonicals.try_emplace(v).second) {
+                                                                    // throw
+                        total += v.size() + 1;
+                    }
+                }
+            }
+
+            // Each canonical is copied when it is first met in record order
+            auto i = (total > 0) ?
+                attach_fresh_buffer(s, total) : nullptr;            // throw
+            for (auto& r : content()) {
+                for (auto& v : r) {
+                    if (v.empty()) {
+                        v = value_type();
+                    } else {
+                        auto& c = canonicals.find(v)->second;
+                        if (c.empty()) {
+                            i = relocate_value(c, v, i);
+                        }
+                        v = c;
+                    }
+                }
+            }
+            if (i) {
+                s.secure_current_upto(i);
+            }
+
+        } else {
+            std::size_t total = 0;
+            for (const auto& r : content()) {
+                for (const auto& v : r) {
+                    if (!v.empty()) {
+                        total += v.size() + 1;
+                    }
+                }
+            }
+
+            auto i = (total > 0) ?
+                attach_fresh_buffer(s, total) : nullptr;            // throw
+            for (auto& r : content()) {
+                for (auto& v : r) {
+                    if (v.empty()) {
+                        v = value_type();
+                    } else {
+                        i = relocate_value(v, v, i);
+                    }
+                }
+            }
+            if (i) {
+                s.secure_current_upto(i);
+            }
+        }
+    }
+
+    static char_type* attach_fresh_buffer(store_type& s, std::size_t size)
+    {
+        const auto [b, bn] = s.generate_buffer(size);   // throw
+        s.add_buffer(b, bn);                            // throw
+        return b;
+    }
+
+    // Copies "from" with its terminating zero onto "to" and makes "value"
+    // refer the copy; returns the last-past-one of the copy
+    static char_type* relocate_value(
+        value_type& value, const value_type& from, char_type* to) noexcept
+    {
+        const auto n = from.size();
+        traits_type::copy(to, from.data(), n);
+        traits_type::assign(to[n], char_type());
+        value = value_type(to, to + n);
+        return to + n + 1;
+    }
+
+public:
     void swap(basic_stored_table& other)
         noexcept(cat_t::propagate_on_container_swap::value
               || cat_t::is_always_equal::value)
@@ -1616,6 +1823,11 @@ public:
         store_.secure_current_upto(secured_last);
     }
 
+    std::pair<char_type*, char_type*> get_current_unsecured() noexcept
+    {
+        return store_.get_current();
+    }
+
 private:
     template <class OtherTable>
     basic_stored_table& operator_plus_assign_impl(OtherTable&& other)
@@ -1934,6 +2146,193 @@ using cstored_table =
 using cwstored_table =
     basic_stored_table<std::deque<std::vector<cwstored_value>>>;
 
+namespace detail::stored {
+
+struct no_canonicals
+{
+    template <class A>
+    explicit no_canonicals(const A&) noexcept
+    {}
+
+    void clear() noexcept
+    {}
+};
+
+} // end detail::stored
+
+template <class Content, class Allocator>
+class stored_table_compactor
+{
+public:
+    using table_type = basic_stored_table<Content, Allocator>;
+
+private:
+    using value_type = typename table_type::value_type;
+    using char_type = typename table_type::char_type;
+    using store_type = typename table_type::store_type;
+    using range_t = std::pair<const char_type*, const char_type*>;
+    using at_t = std::allocator_traits<Allocator>;
+    using ra_t = typename at_t::template rebind_alloc<range_t>;
+    using va_t = typename at_t::template rebind_alloc<value_type>;
+    using canon_t = std::conditional_t<
+        table_type::shares_buffers,
+        std::unordered_set<value_type,
+            std::hash<value_type>, std::equal_to<value_type>, va_t>,
+        detail::stored::no_canonicals>;
+
+private:
+    table_type* table_;
+
+    // Buffers which the table had when *this was constructed; they are
+    // released all together when the migration has completed
+    store_type retired_;
+    std::vector<range_t, ra_t> retired_ranges_; // sorted by their firsts
+
+    canon_t canonicals_;    // values migrated so far, only for const values
+
+    std::size_t total_size_;    // total size of the buffers before migration
+    std::size_t reclaimed_;
+    typename table_type::size_type record_index_;
+    std::size_t value_index_;
+    bool done_;
+
+public:
+    explicit stored_table_compactor(table_type& table) :
+        table_(std::addressof(table)),
+        retired_(std::allocator_arg, table.store_.get_allocator()),
+        retired_ranges_(ra_t(table.get_allocator())),
+        canonicals_(va_t(table.get_allocator())),
+        total_size_(table.store_.get_total_size()), reclaimed_(0),
+        record_index_(0), value_index_(0), done_(false)
+    {
+        table.store_.for_each_secured(
+            [this](const char_type* first, const char_type* last) {
+                retired_ranges_.emplace_back(first, last);          // throw
+            });
+        std::sort(retired_ranges_.begin(), retired_ranges_.end(),
+            [](const range_t& l, const range_t& r) {
+                return std::less<const char_type*>()(l.first, r.first);
+            });
+        retired_.swap_force(table.store_);
+    }
+
+    stored_table_compactor(stored_table_compactor&& other) noexcept :
+        table_(std::exchange(other.table_, nullptr)),
+        retired_(std::move(other.retired_)),
+        retired_ranges_(std::move(other.retired_ranges_)),
+        canonicals_(std::move(other.canonicals_)),
+        total_size_(other.total_size_), reclaimed_(other.reclaimed_),
+        record_index_(other.record_index_), value_index_(other.value_index_),
+        done_(other.done_)
+    {}
+
+    ~stored_table_compactor()
+    {
+        if (table_ && !done_) {
+            // Gives the retired buffers back to the table because some of
+            // the contained values may still be backed by them
+            table_->store_.merge(std::move(retired_));
+        }
+    }
+
+    // Migrates at most max_value_num values; returns whether the migration
+    // has completed
+    bool operator()(
+        std::size_t max_value_num = std::numeric_limits<std::size_t>::max())
+    {
+        if (done_) {
+            return true;
+        }
+        if (table_->records_) {
+            auto& c = table_->content();
+            while (record_index_ < c.size()) {
+                auto& r = *std::next(c.begin(),
+                    static_cast<typename Content::difference_type>(
+                        record_index_));
+                for (auto i = std::next(r.begin(),
+                        static_cast<typename Content::value_type::
+                            difference_type>(value_index_));
+                     i != r.end(); ++i) {
+                    if (max_value_num == 0) {
+                        return false;
+                    }
+                    migrate(*i);                                // throw
+                    ++value_index_;
+                    --max_value_num;
+                }
+                ++record_index_;
+                value_index_ = 0;
+            }
+        }
+        finish();
+        return true;
+    }
+
+    bool done() const noexcept
+    {
+        return done_;
+    }
+
+    std::size_t reclaimed() const noexcept
+    {
+        return reclaimed_;
+    }
+
+private:
+    bool is_retired(const char_type* p) const noexcept
+    {
+        const std::less<const char_type*> lt;
+        const auto i = std::upper_bound(
+            retired_ranges_.cbegin(), retired_ranges_.cend(), p,
+            [lt](const char_type* q, const range_t& r) {
+                return lt(q, r.first);
+            });
+        return (i != retired_ranges_.cbegin()) && lt(p, std::prev(i)->second);
+    }
+
+    void migrate(value_type& value)
+    {
+        if (!is_retired(value.cbegin())) {
+            return;
+        } else if (value.empty()) {
+            value = value_type();
+        } else if constexpr (table_type::shares_buffers) {
+            const auto i = canonicals_.find(value);
+            if (i == canonicals_.cend()) {
+                const auto migrated = table_->import_value(value);  // throw
+                canonicals_.insert(migrated);                       // throw
+                value = migrated;
+            } else {
+                value = *i;
+            }
+        } else {
+            value = table_->import_value(value);                    // throw
+        }
+    }
+
+    void finish() noexcept
+    {
+        {
+            // Destroying r releases all retired buffers
+            store_type r(std::move(retired_));
+        }
+        retired_ranges_.clear();
+        canonicals_.clear();
+        const auto after = table_->store_.get_total_size();
+        reclaimed_ = (total_size_ > after) ?
+            (total_size_ - after) * sizeof(char_type) : 0;
+        done_ = true;
+    }
+};
+
+template <class Content, class Allocator>
+[[nodiscard]]
+stored_table_compactor<Content, Allocator> make_stored_table_compactor(
+    basic_stored_table<Content, Allocator>& table)
+{
+    return stored_table_compactor<Content, Allocator>(table);
+}
+
 enum class stored_table_builder_option : std::uint_fast8_t
 {
     none = 0,
@@ -2107,8 +2506,157 @@ private:
     }
 };
 
+template <class Ch, class Tr>
+struct field_filter
+{
+    virtual ~field_filter() {}
+    virtual bool on_field(std::size_t field_index,
+        std::basic_string_view<Ch, Tr> field_value) = 0;
+};
+
+template <class Ch, class Tr, class T>
+struct typed_field_filter :
+    field_filter<Ch, Tr>, private detail::member_like_base<T>
+{
+    template <class U>
+    explicit typed_field_filter(U&& t) :
+        detail::member_like_base<T>(std::forward<U>(t))
+    {}
+
+    typed_field_filter(typed_field_filter&&) = delete;
+
+    bool on_field(std::size_t field_index,
+        std::basic_string_view<Ch, Tr> field_value)
+    {
+        return this->get()(field_index, field_value);
+    }
+};
+
 } // end detail::stored
 
+class stored_table_projection_error :
+    public text_error
+{
+public:
+    using text_error::text_error;
+};
+
+template <class Ch, class Tr = std::char_traits<Ch>,
+    class Allocator = std::allocator<Ch>>
+class basic_stored_table_projection
+{
+public:
+    using char_type      = Ch;
+    using traits_type    = Tr;
+    using allocator_type = Allocator;
+
+private:
+    using at_t = std::allocator_traits<Allocator>;
+    using string_t = std::basic_string<Ch, Tr, Allocator>;
+    using fa_t = typename at_t::template rebind_alloc<unsigned char>;
+    using sa_t = typename at_t::template rebind_alloc<string_t>;
+
+    // Flags indexed by field indices; std::vector<bool> is avoided because
+    // some implementations of it do not accept fancy pointers
+    std::vector<unsigned char, fa_t> selected_;
+    std::vector<string_t, sa_t> names_; // field names not resolved yet
+
+public:
+    explicit basic_stored_table_projection(
+        const Allocator& alloc = Allocator()) :
+        selected_(fa_t(alloc)), names_(sa_t(alloc))
+    {}
+
+    basic_stored_table_projection(
+        std::initializer_list<std::size_t> field_indices,
+        const Allocator& alloc = Allocator()) :
+        basic_stored_table_projection(alloc)
+    {
+        for (const auto j : field_indices) {
+            select(j);                                      // throw
+        }
+    }
+
+    basic_stored_table_projection(
+        std::initializer_list<std::basic_string_view<Ch, Tr>> field_names,
+        const Allocator& alloc = Allocator()) :
+        basic_stored_table_projection(alloc)
+    {
+        for (const auto& name : field_names) {
+            select(name);                                   // throw
+        }
+    }
+
+    allocator_type get_allocator() const noexcept
+    {
+        return allocator_type(names_.get_allocator());
+    }
+
+    basic_stored_table_projection& select(std::size_t field_index)
+    {
+        if (field_index >= selected_.size()) {
+            selected_.resize(field_index + 1);              // throw
+        }
+        selected_[field_index] = 1;
+        return *this;
+    }
+
+    basic_stored_table_projection& select(
+        std::basic_string_view<Ch, Tr> field_name)
+    {
+        names_.emplace_back(field_name, get_allocator());   // throw
+        return *this;
+    }
+
+    bool is_selected(std::size_t field_index) const noexcept
+    {
+        return (field_index < selected_.size())
+            && (selected_[field_index] != 0);
+    }
+
+    bool has_unresolved_names() const noexcept
+    {
+        return !names_.empty();
+    }
+
+    // Selects field_index if [first, last) is one of the unresolved names
+    // and then returns whether the field is selected
+    bool resolve(std::size_t field_index, const Ch* first, const Ch* last)
+    {
+        const std::basic_string_view<Ch, Tr> name(first, last - first);
+        const auto i = std::find(names_.cbegin(), names_.cend(), name);
+        if (i != names_.cend()) {
+            select(field_index);                            // throw
+            names_.erase(i);
+            return true;
+        } else {
+            return is_selected(field_index);
+        }
+    }
+
+    [[noreturn]]
+    void throw_unresolved() const
+    {
+        assert(!names_.empty());
+        using namespace std::string_view_literals;
+        constexpr auto what_core = "No field found for the projected name"sv;
+        try {
+            std::ostringstream what;
+            what << what_core << ": ";
+            detail::write_ntmbs(what,
+                names_.front().cbegin(), names_.front().cend());
+            throw stored_table_projection_error(std::move(what).str());
+        } catch (const stored_table_projection_error&) {
+            throw;
+        } catch (...) {
+            throw stored_table_projection_error(what_core);
+        }
+    }
+};
+
+using stored_table_projection = basic_stored_table_projection<char>;
+using wstored_table_projection = basic_stored_table_projection<wchar_t>;
+
 template <class Content, class Allocator,
     stored_table_builder_option Options = stored_table_builder_option::none>
 class stored_table_builder :
@@ -2117,11 +2665,22 @@ class stored_table_builder :
 public:
     using table_type = basic_stored_table<Content, Allocator>;
     using char_type = typename table_type::char_type;
+    using projection_type = basic_stored_table_projection<
+        char_type, typename table_type::traits_type,
+        typename std::allocator_traits<Allocator>::
+            template rebind_alloc<char_type>>;
 
 private:
+    using traits_t = typename table_type::traits_type;
     using h_t = detail::stored::end_record_handler<table_type>;
     using ph_t = typename std::allocator_traits<Allocator>::
         template rebind_traits<h_t>::pointer;
+    using f_t = detail::stored::field_filter<char_type, traits_t>;
+    using pf_t = typename std::allocator_traits<Allocator>::
+        template rebind_traits<f_t>::pointer;
+    using range_t = std::pair<char_type*, char_type*>;
+    using ra_t = typename std::allocator_traits<Allocator>::
+        template rebind_alloc<range_t>;
 
 private:
     char_type* current_buffer_holder_;
@@ -2135,27 +2694,52 @@ private:
 
     ph_t end_record_;
 
+    projection_type projection_;
+    std::size_t field_index_;
+    bool projected_;    // whether projection_ is in effect
+    bool resolving_;    // whether in the header record to resolve names
+    bool skipping_;     // whether the current field is not to be stored
+
+    // When a projection or a filter is in effect, we are "selective";
+    // the parser works on current_buffer_holder_, which is never committed
+    // to the store, and the values to be stored are retained in it until the
+    // end of the record and then copied into the store
+    pf_t filter_;
+    std::vector<range_t, ra_t> pending_;
+    bool rejected_;     // whether the current record has been rejected
+
 public:
     explicit stored_table_builder(table_type& table,
                                   std::size_t max_record_num = 0) :
-        detail::stored::arrange<Content, Options>(table.content()),
-        current_buffer_holder_(nullptr), current_buffer_(nullptr),
-        field_begin_(nullptr), table_(std::addressof(table)),
-        end_record_((max_record_num > 0) ?
-            allocate_construct(
-                [remaining = max_record_num](table_type&) mutable {
-                    return --remaining > 0;
-                }) : nullptr)
+        stored_table_builder(table,
+            no_projection(table), false,
+            max_limiter(table, max_record_num))
     {}
 
     template <class E,
-              std::enable_if_t<!std::is_integral_v<std::decay_t<E>>>*
+              std::enable_if_t<
+                    !std::is_integral_v<std::decay_t<E>>
+                 && !std::is_same_v<std::decay_t<E>, projection_type>>*
                   = nullptr>
     stored_table_builder(table_type& table, E&& e) :
-        detail::stored::arrange<Content, Options>(table.content()),
-        current_buffer_holder_(nullptr), current_buffer_(nullptr),
-        field_begin_(nullptr), table_(std::addressof(table)),
-        end_record_(allocate_construct(std::forward<E>(e)))
+        stored_table_builder(table,
+            no_projection(table), false,
+            allocate_construct<h_t>(table, std::forward<E>(e)))
+    {}
+
+    stored_table_builder(table_type& table, projection_type projection,
+                         std::size_t max_record_num = 0) :
+        stored_table_builder(table, std::move(projection), true,
+            max_limiter(table, max_record_num))
+    {}
+
+    template <class E,
+              std::enable_if_t<!std::is_integral_v<std::decay_t<E>>>*
+                  = nullptr>
+    stored_table_builder(table_type& table, projection_type projection,
+                         E&& e) :
+        stored_table_builder(table, std::move(projection), true,
+            allocate_construct<h_t>(table, std::forward<E>(e)))
     {}
 
     stored_table_builder(stored_table_builder&& other) noexcept :
@@ -2166,9 +2750,29 @@ public:
         current_buffer_size_(other.current_buffer_size_),
         field_begin_(other.field_begin_), field_end_(other.field_end_),
         table_(other.table_),
-        end_record_(std::exchange(other.end_record_, nullptr))
+        end_record_(std::exchange(other.end_record_, nullptr)),
+        projection_(std::move(other.projection_)),
+        field_index_(other.field_index_), projected_(other.projected_),
+        resolving_(other.resolving_), skipping_(other.skipping_),
+        filter_(std::exchange(other.filter_, nullptr)),
+        pending_(std::move(other.pending_)), rejected_(other.rejected_)
+    {}
+
+private:
+    // Takes the ownership of end_record over
+    stored_table_builder(table_type& table, projection_type&& projection,
+                         bool projected, ph_t end_record) noexcept :
+        detail::stored::arrange<Content, Options>(table.content()),
+        current_buffer_holder_(nullptr), current_buffer_(nullptr),
+        field_begin_(nullptr), table_(std::addressof(table)),
+        end_record_(end_record), projection_(std::move(projection)),
+        field_index_(0), projected_(projected),
+        resolving_(projected && projection_.has_unresolved_names()),
+        skipping_(false), filter_(nullptr),
+        pending_(ra_t(table.get_allocator())), rejected_(false)
     {}
 
+public:
     ~stored_table_builder()
     {
         if (current_buffer_holder_) {
@@ -2183,21 +2787,63 @@ public:
                 a, pt_t::pointer_to(*current_buffer_), current_buffer_size_);
         }
         if (end_record_) {
-            destroy_deallocate(end_record_);
+            destroy_deallocate<h_t>(end_record_);
+        }
+        if (filter_) {
+            destroy_deallocate<f_t>(filter_);
         }
     }
 
+    // Makes the records in which f returns false for any field rejected
+    // before they are stored; must not be called while parsing
+    template <class F>
+    stored_table_builder& filter_records(F&& f) &
+    {
+        const auto p = allocate_construct<f_t>(
+            *table_, std::forward<F>(f));                       // throw
+        if (filter_) {
+            destroy_deallocate<f_t>(filter_);
+        }
+        filter_ = p;
+        return *this;
+    }
+
+    template <class F>
+    stored_table_builder&& filter_records(F&& f) &&
+    {
+        return std::move(filter_records(std::forward<F>(f)));   // throw
+    }
+
 private:
-    template <class T>
-    ph_t allocate_construct(T&& t)
+    static projection_type no_projection(const table_type& table)
+    {
+        return projection_type(
+            typename projection_type::allocator_type(table.get_allocator()));
+    }
+
+    static ph_t max_limiter(table_type& table, std::size_t max_record_num)
+    {
+        return (max_record_num > 0) ?
+            allocate_construct<h_t>(table,
+                [remaining = max_record_num](table_type&) mutable {
+                    return --remaining > 0;
+                }) : nullptr;
+    }
+
+    template <class H, class T>
+    static auto allocate_construct(table_type& table, T&& t)
     {
         using t_t = std::decay_t<T>;
-        using th_t = detail::stored::typed_end_record_handler<table_type, t_t>;
+        using th_t = std::conditional_t<std::is_same_v<H, h_t>,
+            detail::stored::typed_end_record_handler<table_type, t_t>,
+            detail::stored::typed_field_filter<char_type, traits_t, t_t>>;
 
         using at_t = typename std::allocator_traits<Allocator>::
                         template rebind_traits<th_t>;
         using a_t = typename at_t::allocator_type;
-        a_t a(table_->get_allocator());
+        using hat_t = typename std::allocator_traits<Allocator>::
+                        template rebind_traits<H>;
+        a_t a(table.get_allocator());
 
         const auto p = at_t::allocate(a, 1);                        // throw
         try {
@@ -2206,30 +2852,37 @@ private:
             at_t::deallocate(a, p, 1);
             throw;
         }
-        return p;
+        return typename hat_t::pointer(p);
     }
 
-    void destroy_deallocate(ph_t p) noexcept
+    template <class H, class P>
+    void destroy_deallocate(P p) noexcept
     {
         using at_t = typename std::allocator_traits<Allocator>::
-                        template rebind_traits<h_t>;
+                        template rebind_traits<H>;
         using a_t = typename at_t::allocator_type;
         a_t a(table_->get_allocator());
 
-        p->~end_record_handler();
+        p->~H();
         at_t::deallocate(a, p, 1);
     }
 
 public:
     void start_record(char_type* /*record_begin*/)
     {
-        this->new_record(table_->content());    // throw
+        if (!is_selective()) {
+            this->new_record(table_->content());    // throw
+        }
+        field_index_ = 0;
+        skipping_ = is_skipped();
     }
 
     void update(char_type* first, char_type* last)
     {
-        if (field_begin_) {
-            table_type::traits_type::move(field_end_, first, last - first);
+        if (skipping_) {
+            return;
+        } else if (field_begin_) {
+            traits_t::move(field_end_, first, last - first);
             field_end_ += last - first;
         } else {
             field_begin_ = first;
@@ -2239,24 +2892,44 @@ public:
 
     void finalize(char_type* first, char_type* last)
     {
-        update(first, last);
-        table_type::traits_type::assign(*field_end_, char_type());
-        if (current_buffer_holder_) {
-            const auto cbh = std::exchange(current_buffer_holder_, nullptr);
-            table_->add_buffer(cbh, current_buffer_size_);    // throw
+        if (!skipping_) {
+            update(first, last);
+            if (is_selective()) {
+                finalize_selective();                           // throw
+            } else {
+                traits_t::assign(*field_end_, char_type());
+                store_field();                                  // throw
+            }
+            field_begin_ = nullptr;
         }
-        this->new_value(table_->content(), field_begin_, field_end_); // throw
-        table_->secure_current_upto(field_end_ + 1);
-        field_begin_ = nullptr;
+        ++field_index_;
+        skipping_ = is_skipped();
     }
 
     bool end_record(char_type* /*record_end*/)
     {
+        if (resolving_) {
+            resolving_ = false;
+            if (projection_.has_unresolved_names()) {
+                projection_.throw_unresolved();                 // throw
+            }
+        }
+        if (is_selective()) {
+            if (std::exchange(rejected_, false)) {
+                pending_.clear();
+                return true;
+            }
+            store_pending();                                    // throw
+        }
         return (!end_record_) || end_record_->on_end_record(*table_);
     }
 
     [[nodiscard]] std::pair<char_type*, std::size_t> get_buffer()
     {
+        if (is_selective()) {
+            return get_buffer_selective();                      // throw
+        }
+
         std::size_t length;
         if (field_begin_) {
             // In an active value, whose length is "length" so far
@@ -2264,7 +2937,6 @@ public:
             // We'd like to move the active value to the beginning of the
             // returned buffer
             const std::size_t next_buffer_size = get_next_buffer_size(length);
-            using traits_t = typename table_type::traits_type;
             if (current_buffer_holder_
              && (current_buffer_size_ >= next_buffer_size)) {
                 // The current buffer contains no other values
@@ -2306,6 +2978,125 @@ public:
     }
 
 private:
+    bool is_selective() const noexcept
+    {
+        return projected_ || filter_;
+    }
+
+    bool is_skipped() const noexcept
+    {
+        if (resolving_) {
+            return false;
+        } else if (rejected_) {
+            return true;
+        } else {
+            // Fields not to be stored must be seen by the filter if any
+            return projected_ && (!filter_)
+                && (!projection_.is_selected(field_index_));
+        }
+    }
+
+    void store_field()
+    {
+        if (current_buffer_holder_) {
+            const auto cbh = std::exchange(current_buffer_holder_, nullptr);
+            table_->add_buffer(cbh, current_buffer_size_);    // throw
+        }
+        this->new_value(table_->content(), field_begin_, field_end_); // throw
+        table_->secure_current_upto(field_end_ + 1);
+    }
+
+    void finalize_selective()
+    {
+        const bool selected = (!projected_)
+            || (resolving_ ?
+                projection_.resolve(field_index_, field_begin_, field_end_) :
+                projection_.is_selected(field_index_));         // throw
+        if (rejected_) {
+            // Only to resolve the names in the header
+        } else if (filter_ && !filter_->on_field(field_index_,
+                std::basic_string_view<char_type, traits_t>(
+                    field_begin_, field_end_ - field_begin_))) {   // throw
+            rejected_ = true;
+            pending_.clear();
+        } else if (selected) {
+            pending_.emplace_back(field_begin_, field_end_);        // throw
+        }
+    }
+
+    void store_pending()
+    {
+        this->new_record(table_->content());                        // throw
+        for (const auto& r : pending_) {
+            const auto length = static_cast<std::size_t>(r.second - r.first);
+            auto [first, last] = table_->get_current_unsecured();
+            if (static_cast<std::size_t>(last - first) <= length) {
+                std::size_t size;
+                std::tie(first, size) = table_->generate_buffer(
+                    std::max(length + 1, table_->get_buffer_size()));
+                                                                    // throw
+                table_->add_buffer(first, size);                    // throw
+            }
+            traits_t::copy(first, r.first, length);
+            traits_t::assign(first[length], char_type());
+            table_->secure_current_upto(first + length + 1);
+            this->new_value(table_->content(), first, first + length);
+                                                                    // throw
+        }
+        pending_.clear();
+    }
+
+    std::pair<char_type*, std::size_t> get_buffer_selective()
+    {
+        // We'd like to move the pending values and the active value to the
+        // beginning of the returned buffer
+        char_type* kept_first = field_begin_;
+        char_type* kept_last = field_end_;
+        if (!pending_.empty()) {
+            kept_first = pending_.front().first;
+            if (!field_begin_) {
+                kept_last = pending_.back().second;
+            }
+        }
+        const std::size_t length = kept_first ?
+            static_cast<std::size_t>(kept_last - kept_first) : 0;
+        const std::size_t next_buffer_size = get_next_buffer_size(length);
+        if (current_buffer_holder_
+         && (current_buffer_size_ >= next_buffer_size)) {
+            if (length > 0) {
+                traits_t::move(current_buffer_holder_, kept_first, length);
+            }
+        } else {
+            const auto p = table_->generate_buffer(next_buffer_size);
+                                                                    // throw
+            if (length > 0) {
+                traits_t::copy(p.first, kept_first, length);
+            }
+            if (current_buffer_holder_) {
+                table_->consume_buffer(
+                    current_buffer_holder_, current_buffer_size_);
+            }
+            std::tie(current_buffer_holder_, current_buffer_size_) = p;
+        }
+
+        const auto rebase = [kept_first, b = current_buffer_holder_]
+                            (char_type* q) {
+            return b + (q - kept_first);
+        };
+        for (auto& r : pending_) {
+            r = range_t(rebase(r.first), rebase(r.second));
+        }
+        if (field_begin_) {
+            field_begin_ = rebase(field_begin_);
+            field_end_   = rebase(field_end_);
+        }
+
+        current_buffer_ = current_buffer_holder_;
+        const auto effective_size = current_buffer_size_ - length;
+        assert(effective_size > 1);
+        return std::make_pair(current_buffer_ + length, effective_size);
+    }
+
     std::size_t get_next_buffer_size(std::size_t occupied) const
     {
         constexpr std::size_t max = std::numeric_limits<std::size_t>::max();
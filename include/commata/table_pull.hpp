@@ -138,37 +138,118 @@ template <class T>
 constexpr bool has_nothrow_get_physical_position_v =
     decltype(has_nothrow_get_physical_position_impl::check<T>(nullptr))();
 
+struct has_skip_plain_records_impl
+{
+    template <class T>
+    static auto check(T*) -> decltype(
+        std::declval<std::size_t&>() =
+            std::declval<T&>().skip_plain_records(
+                std::declval<std::size_t>(), std::declval<bool>()),
+        std::true_type());
+
+    template <class T>
+    static auto check(...) -> std::false_type;
+};
+
+template <class T>
+constexpr bool has_skip_plain_records_v =
+    decltype(has_skip_plain_records_impl::check<T>(nullptr))();
+
+// A parsing event with the data that come with it
+template <class Ch>
+struct event
+{
+    primitive_table_pull_state state;
+    std::uint_fast8_t data_size;
+    Ch* data[2];
+};
+
+// A queue of parsing events, which is drained by the consumer before the
+// parser is resumed; the first N events are stored in place and the rest,
+// if any, spill over into dynamically allocated storage
+template <class Event, std::size_t N, class Allocator>
+class event_queue
+{
+    std::size_t size_;
+    Event head_[N];
+    std::vector<Event, Allocator> tail_;
+
+public:
+    static constexpr std::size_t inline_capacity = N;
+
+    explicit event_queue(const Allocator& alloc = Allocator()) :
+        size_(0), tail_(alloc)
+    {}
+
+    std::size_t size() const noexcept
+    {
+        return size_;
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return size_ == 0;
+    }
+
+    const Event& operator[](std::size_t i) const noexcept
+    {
+        assert(i < size_);
+        return (i < N) ? head_[i] : tail_[i - N];
+    }
+
+    const Event& back() const noexcept
+    {
+        return (*this)[size_ - 1];
+    }
+
+    void push_back(const Event& e)
+    {
+        if (size_ < N) {
+            head_[size_] = e;
+        } else {
+            tail_.push_back(e);                                     // throw
+        }
+        ++size_;
+    }
+
+    void clear() noexcept
+    {
+        size_ = 0;
+        tail_.clear();
+    }
+};
+
 template <class Ch, class Allocator, primitive_table_pull_handle Handle>
 class handler
 {
 public:
     using char_type = Ch;
-    using state_queue_element_type =
-        std::pair<primitive_table_pull_state, std::uint_fast8_t>;
+    using event_type = event<Ch>;
 
 private:
     using at_t = std::allocator_traits<Allocator>;
 
-    using state_queue_a_t = allocation_only_allocator<
-        typename at_t::template rebind_alloc<state_queue_element_type>>;
-    using data_queue_a_t = allocation_only_allocator<
-        typename at_t::template rebind_alloc<Ch*>>;
+    using event_queue_a_t = allocation_only_allocator<
+        typename at_t::template rebind_alloc<event_type>>;
+
+    // The builtin parsers enqueue at most three events on each step and at
+    // most five more at the end of a buffer, so batched records leave this
+    // many spare slots in order to stay within the in-place storage
+    static constexpr std::size_t batching_margin = 8;
 
 public:
-    using state_queue_type =
-        std::vector<state_queue_element_type, state_queue_a_t>;
-    using data_queue_type = std::vector<char_type*, data_queue_a_t>;
+    using event_queue_type = event_queue<event_type, 32, event_queue_a_t>;
 
 private:
-    state_queue_type sq_;
-    data_queue_type dq_;
+    event_queue_type eq_;
     std::size_t yield_location_;
     bool collects_data_;
+    bool batches_records_;
 
 public:
     handler(std::allocator_arg_t, const Allocator& alloc) :
-        sq_(state_queue_a_t(alloc)), dq_(data_queue_a_t(alloc)),
-        yield_location_(0), collects_data_(true)
+        eq_(event_queue_a_t(alloc)),
+        yield_location_(0), collects_data_(true), batches_records_(false)
     {}
 
     handler(const handler& other) = delete;
@@ -176,34 +257,35 @@ public:
 
     ~handler() = default;
 
-    const state_queue_type& state_queue() const noexcept
+    const event_queue_type& queue() const noexcept
     {
-        return sq_;
+        return eq_;
     }
 
-    state_queue_type& state_queue() noexcept
+    event_queue_type& queue() noexcept
     {
-        return sq_;
+        return eq_;
     }
 
-    const data_queue_type& data_queue() const noexcept
+    bool is_discarding_data() const noexcept
     {
-        return dq_;
+        return !collects_data_;
     }
 
-    data_queue_type& data_queue() noexcept
+    handler& set_discarding_data(bool b = true) noexcept
     {
-        return dq_;
+        collects_data_ = !b;
+        return *this;
     }
 
-    bool is_discarding_data() const noexcept
+    bool is_batching_records() const noexcept
     {
-        return !collects_data_;
+        return batches_records_;
     }
 
-    handler& set_discarding_data(bool b = true) noexcept
+    handler& set_batching_records(bool b = true) noexcept
     {
-        collects_data_ = !b;
+        batches_records_ = b;
         return *this;
     }
 
@@ -212,43 +294,22 @@ public:
         [[maybe_unused]] char_type* buffer_end)
     {
         if constexpr (handles(primitive_table_pull_handle::start_buffer)) {
-            if (collects_data_) {
-                sq_.emplace_back(
-                    primitive_table_pull_state::start_buffer, dn(2));
-                dq_.push_back(buffer_begin);
-                dq_.push_back(buffer_end);
-            } else {
-                sq_.emplace_back(
-                    primitive_table_pull_state::start_buffer, dn(0));
-            }
+            enqueue(primitive_table_pull_state::start_buffer,
+                buffer_begin, buffer_end);
         }
     }
 
     void end_buffer([[maybe_unused]] char_type* buffer_end)
     {
         if constexpr (handles(primitive_table_pull_handle::end_buffer)) {
-            if (collects_data_) {
-                sq_.emplace_back(
-                    primitive_table_pull_state::end_buffer, dn(1));
-                dq_.push_back(buffer_end);
-            } else {
-                sq_.emplace_back(
-                    primitive_table_pull_state::end_buffer, dn(0));
-            }
+            enqueue(primitive_table_pull_state::end_buffer, buffer_end);
         }
     }
 
     void start_record([[maybe_unused]] char_type* record_begin)
     {
         if constexpr (handles(primitive_table_pull_handle::start_record)) {
-            if (collects_data_) {
-                sq_.emplace_back(
-                    primitive_table_pull_state::start_record, dn(1));
-                dq_.push_back(record_begin);
-            } else {
-                sq_.emplace_back(
-                    primitive_table_pull_state::start_record, dn(0));
-            }
+            enqueue(primitive_table_pull_state::start_record, record_begin);
         }
     }
 
@@ -257,13 +318,7 @@ public:
         [[maybe_unused]] char_type* last)
     {
         if constexpr (handles(primitive_table_pull_handle::update)) {
-            if (collects_data_) {
-                sq_.emplace_back(primitive_table_pull_state::update, dn(2));
-                dq_.push_back(first);
-                dq_.push_back(last);
-            } else {
-                sq_.emplace_back(primitive_table_pull_state::update, dn(0));
-            }
+            enqueue(primitive_table_pull_state::update, first, last);
         }
     }
 
@@ -272,27 +327,14 @@ public:
         [[maybe_unused]] char_type* last)
     {
         if constexpr (handles(primitive_table_pull_handle::finalize)) {
-            if (collects_data_) {
-                sq_.emplace_back(primitive_table_pull_state::finalize, dn(2));
-                dq_.push_back(first);
-                dq_.push_back(last);
-            } else {
-                sq_.emplace_back(primitive_table_pull_state::finalize, dn(0));
-            }
+            enqueue(primitive_table_pull_state::finalize, first, last);
         }
     }
 
     void end_record([[maybe_unused]] char_type* record_end)
     {
         if constexpr (handles(primitive_table_pull_handle::end_record)) {
-            if (collects_data_) {
-                sq_.emplace_back(
-                    primitive_table_pull_state::end_record, dn(1));
-                dq_.push_back(record_end);
-            } else {
-                sq_.emplace_back(
-                    primitive_table_pull_state::end_record, dn(0));
-            }
+            enqueue(primitive_table_pull_state::end_record, record_end);
         }
     }
 
@@ -300,20 +342,20 @@ public:
     {
         if constexpr (
                 handles(primitive_table_pull_handle::empty_physical_line)) {
-            if (collects_data_) {
-                sq_.emplace_back(
-                    primitive_table_pull_state::empty_physical_line, dn(1));
-                dq_.push_back(where);
-            } else {
-                sq_.emplace_back(
-                    primitive_table_pull_state::empty_physical_line, dn(0));
-            }
+            enqueue(primitive_table_pull_state::empty_physical_line, where);
         }
     }
 
     bool yield(std::size_t location) noexcept
     {
-        if ((location != static_cast<std::size_t>(-1)) && sq_.empty()) {
+        if ((location != static_cast<std::size_t>(-1)) && eq_.empty()) {
+            return false;
+        } else if ((location == 1) && batches_records_
+                && !ends_record(eq_.back().state)
+                && (eq_.size() + batching_margin
+                        <= event_queue_type::inline_capacity)) {
+            // Location 1 is in the middle of a buffer, so the data collected
+            // so far stay valid until the parser reaches the buffer's end
             return false;
         } else {
             yield_location_ = location;
@@ -332,10 +374,29 @@ public:
     }
 
 private:
-    template <class N>
-    static auto dn(N n)
+    void enqueue(primitive_table_pull_state s, char_type* p)
+    {
+        if (collects_data_) {
+            eq_.push_back({ s, 1, { p, nullptr } });                // throw
+        } else {
+            eq_.push_back({ s, 0, { nullptr, nullptr } });          // throw
+        }
+    }
+
+    void enqueue(primitive_table_pull_state s,
+        char_type* first, char_type* last)
+    {
+        if (collects_data_) {
+            eq_.push_back({ s, 2, { first, last } });               // throw
+        } else {
+            eq_.push_back({ s, 0, { nullptr, nullptr } });          // throw
+        }
+    }
+
+    static bool ends_record(primitive_table_pull_state s) noexcept
     {
-        return static_cast<typename state_queue_element_type::second_type>(n);
+        return (s == primitive_table_pull_state::end_record)
+            || (s == primitive_table_pull_state::empty_physical_line);
     }
 };
 
@@ -453,17 +514,14 @@ private:
             std::declval<reference_handler<handler_t>>()))>);
 
     using parser_t = typename TableSource::template parser_type<
-        reference_handler<handler_t>>;
+        reference_handler<handler_t>, Allocator>;
 
-    std::size_t i_sq_;
-    std::size_t i_dq_;
+    std::size_t i_eq_;
     handler_p_t handler_;
-    typename handler_t::state_queue_type* sq_;
-    typename handler_t::data_queue_type* dq_;
+    typename handler_t::event_queue_type* eq_;
     detail::base_member_pair<allocator_type, parser_t> ap_;
 
-    static typename handler_t::state_queue_type sq_moved_from;
-    static typename handler_t::data_queue_type dq_moved_from;
+    static typename handler_t::event_queue_type eq_moved_from;
 
 public:
     static constexpr bool physical_position_available =
@@ -488,27 +546,23 @@ public:
         = nullptr>
     primitive_table_pull(std::allocator_arg_t, const Allocator& alloc,
         TableSourceR&& in, std::size_t buffer_size = 0) :
-        i_sq_(0), i_dq_(0),
+        i_eq_(0),
         handler_(create_handler(alloc, std::allocator_arg, alloc)),
-        sq_(&handler_->state_queue()), dq_(&handler_->data_queue()),
+        eq_(&handler_->queue()),
         ap_(alloc, std::forward<TableSourceR>(in)(
                             wrap_ref(*handler_), buffer_size, alloc))
     {
-        sq_->emplace_back(
-            primitive_table_pull_state::before_parse,
-            static_cast<typename handler_t::
-                    state_queue_element_type::second_type>(0));
+        eq_->push_back(
+            { primitive_table_pull_state::before_parse, 0, {} });
     }
 
     primitive_table_pull(primitive_table_pull&& other) noexcept :
-        i_sq_(std::exchange(other.i_sq_, 0)),
-        i_dq_(std::exchange(other.i_dq_, 0)),
+        i_eq_(std::exchange(other.i_eq_, 0)),
         handler_(std::exchange(other.handler_, nullptr)),
-        sq_(&handler_->state_queue()), dq_(&handler_->data_queue()),
+        eq_(&handler_->queue()),
         ap_(std::move(other.ap_))
     {
-        other.sq_ = &sq_moved_from;
-        other.dq_ = &dq_moved_from;
+        other.eq_ = &eq_moved_from;
     }
 
     ~primitive_table_pull()
@@ -536,10 +590,23 @@ public:
         return *this;
     }
 
+    bool is_batching_records() const noexcept
+    {
+        return handler_ && handler_->is_batching_records();
+    }
+
+    primitive_table_pull& set_batching_records(bool b = true) noexcept
+    {
+        if (handler_) {
+            handler_->set_batching_records(b);
+        }
+        return *this;
+    }
+
     primitive_table_pull_state state() const noexcept
     {
-        assert(sq_->size() > i_sq_);
-        return (*sq_)[i_sq_].first;
+        assert(eq_->size() > i_eq_);
+        return (*eq_)[i_eq_].state;
     }
 
     explicit operator bool() const noexcept
@@ -550,42 +617,46 @@ public:
 
     primitive_table_pull& operator()()
     {
-        assert(!sq_->empty());
-        const auto dsize = (*sq_)[i_sq_].second;
-
-        if (dsize > 0) {
-            i_dq_ += dsize;
-            if (i_dq_ == dq_->size()) {
-                dq_->clear();
-                i_dq_ = 0;
+        assert(!eq_->empty());
+        ++i_eq_;
+        if (i_eq_ == eq_->size()) {
+            if (eq_ != std::addressof(eq_moved_from)) {
+                eq_->clear();
             }
+            i_eq_ = 0;
         }
 
-        ++i_sq_;
-        if (i_sq_ == sq_->size()) {
-            if (sq_ != std::addressof(sq_moved_from)) {
-                sq_->clear();
+        if (eq_->empty()) {
+            ap_.member()();
+            if (eq_->empty()) {
+                eq_->push_back({ primitive_table_pull_state::eof, 0, {} });
             }
-            i_sq_ = 0;
         }
+        return *this;
+    }
 
-        if (sq_->empty()) {
-            ap_.member()();
-            if (sq_->empty()) {
-                sq_->emplace_back(
-                    primitive_table_pull_state::eof,
-                    static_cast<typename handler_t::state_queue_element_type::
-                        second_type>(0));
+    // Skips at most n records following the end of the record which is the
+    // current event without reporting any events on them if it is possible
+    // to do so cheaply, and returns the number of the skipped records
+    std::size_t skip_plain_records(std::size_t n, bool counts_empty_lines)
+    {
+        if constexpr (detail::pull::has_skip_plain_records_v<parser_t>) {
+            const auto s = state();
+            if ((i_eq_ + 1 == eq_->size())
+             && ((s == primitive_table_pull_state::end_record)
+              || (s == primitive_table_pull_state::empty_physical_line))) {
+                return ap_.member().skip_plain_records(
+                    n, counts_empty_lines);
             }
         }
-        return *this;
+        return 0;
     }
 
 private:
     const char_type* access_impl(size_type i) const
     {
         assert(i < data_size());
-        return (*dq_)[i_dq_ + i];
+        return (*eq_)[i_eq_].data[i];
     }
 
     const char_type* at_impl(size_type i) const
@@ -604,7 +675,7 @@ private:
 public:
     size_type data_size() const noexcept
     {
-        return (*sq_)[i_sq_].second;
+        return (*eq_)[i_eq_].data_size;
     }
 
     size_type max_data_size() const noexcept
@@ -663,19 +734,13 @@ primitive_table_pull(std::allocator_arg_t, Allocator, TableSource, Args...)
 template <class TableSource, primitive_table_pull_handle Handle,
             class Allocator>
 typename primitive_table_pull<TableSource, Handle, Allocator>::
-        handler_t::state_queue_type
-primitive_table_pull<TableSource, Handle, Allocator>::
-    sq_moved_from = { std::make_pair(
-        primitive_table_pull_state::eof,
-        typename primitive_table_pull<TableSource, Handle, Allocator>::
-            handler_t::state_queue_element_type::second_type(0)) };
-
-template <class TableSource, primitive_table_pull_handle Handle,
-            class Allocator>
-typename primitive_table_pull<TableSource, Handle, Allocator>::
-        handler_t::data_queue_type
+        handler_t::event_queue_type
 primitive_table_pull<TableSource, Handle, Allocator>::
-    dq_moved_from = {};
+    eq_moved_from = [] {
+        typename handler_t::event_queue_type q;
+        q.push_back({ primitive_table_pull_state::eof, 0, {} });
+        return q;
+    }();
 
 enum class table_pull_state : std::uint_fast8_t
 {
@@ -715,6 +780,192 @@ struct table_pull_base_not_evading_copy
     }
 };
 
+// A view over the contiguously stored fields of a record
+template <class View>
+class record_view
+{
+    const View* begin_;
+    const View* end_;
+
+public:
+    using value_type = View;
+    using size_type = std::size_t;
+    using const_iterator = const View*;
+    using iterator = const_iterator;
+
+    record_view() noexcept :
+        begin_(nullptr), end_(nullptr)
+    {}
+
+    record_view(const View* begin, const View* end) noexcept :
+        begin_(begin), end_(end)
+    {}
+
+    const_iterator begin() const noexcept
+    {
+        return begin_;
+    }
+
+    const_iterator end() const noexcept
+    {
+        return end_;
+    }
+
+    size_type size() const noexcept
+    {
+        return static_cast<size_type>(end_ - begin_);
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return begin_ == end_;
+    }
+
+    const View& operator[](size_type j) const noexcept
+    {
+        assert(j < size());
+        return begin_[j];
+    }
+
+    const View& at(size_type j) const
+    {
+        if (j < size()) {
+            return begin_[j];
+        } else {
+            std::ostringstream what;
+            what << "Too large field index " << j
+                 << ": the number of the fields is " << size();
+            throw std::out_of_range(std::move(what).str());
+        }
+    }
+};
+
+// Stores the fields of a record, referring to them in the buffer as long as
+// it is alive; a nonconst buffer is unescaped in place
+template <class BufferCh, class Tr, class Allocator>
+class record_store
+{
+public:
+    using char_type = std::remove_const_t<BufferCh>;
+    using view_type = std::basic_string_view<char_type, Tr>;
+
+private:
+    // A field which resides in the buffer at begin or in value_ at offset
+    // if begin is null
+    struct field
+    {
+        const char_type* begin;
+        std::size_t offset;
+        std::size_t size;
+    };
+
+    using at_t = std::allocator_traits<Allocator>;
+    using fields_a_t = typename at_t::template rebind_alloc<field>;
+    using value_a_t = typename at_t::template rebind_alloc<char_type>;
+    using views_a_t = typename at_t::template rebind_alloc<view_type>;
+
+    // the first in_buffer_ fields have been taken out of the buffer
+    std::vector<field, fields_a_t> fields_;
+    std::size_t in_buffer_;
+    bool open_;
+    std::vector<char_type, value_a_t> value_;
+    std::vector<view_type, views_a_t> views_;
+
+public:
+    explicit record_store(const Allocator& alloc) :
+        fields_(fields_a_t(alloc)), in_buffer_(0), open_(false),
+        value_(value_a_t(alloc)), views_(views_a_t(alloc))
+    {}
+
+    record_store(record_store&& other) noexcept :
+        fields_(std::move(other.fields_)),
+        in_buffer_(std::exchange(other.in_buffer_, 0)),
+        open_(std::exchange(other.open_, false)),
+        value_(std::move(other.value_)),
+        views_(std::move(other.views_))
+    {}
+
+    ~record_store() = default;
+
+    void clear() noexcept
+    {
+        fields_.clear();
+        in_buffer_ = 0;
+        open_ = false;
+        value_.clear();
+        views_.clear();
+    }
+
+    void update(BufferCh* first, BufferCh* last)
+    {
+        const auto len = static_cast<std::size_t>(last - first);
+        if (!open_) {
+            fields_.push_back({ first, 0, len });                   // throw
+            open_ = true;
+            return;
+        }
+
+        auto& f = fields_.back();
+        if (!f.begin) {
+            // The open field is always at the end of value_
+            value_.insert(value_.cend(), first, last);              // throw
+            f.size += len;
+        } else if (f.begin + f.size == first) {
+            f.size += len;
+        } else if constexpr (std::is_const_v<BufferCh>) {
+            // We must not write into the buffer of the source
+            const auto offset = value_.size();
+            value_.reserve(offset + f.size + len);                  // throw
+            value_.insert(value_.cend(), f.begin, f.begin + f.size);
+            value_.insert(value_.cend(), first, last);
+            f.begin = nullptr;
+            f.offset = offset;
+            f.size += len;
+        } else {
+            Tr::move(const_cast<char_type*>(f.begin + f.size), first, len);
+            f.size += len;
+        }
+    }
+
+    void finalize(BufferCh* first, BufferCh* last)
+    {
+        update(first, last);                                        // throw
+        open_ = false;
+    }
+
+    // Takes the fields out of the buffer which is about to be released
+    void evacuate()
+    {
+        for (auto i = in_buffer_, ie = fields_.size(); i != ie; ++i) {
+            auto& f = fields_[i];
+            if (f.begin) {
+                const auto offset = value_.size();
+                value_.insert(value_.cend(),
+                    f.begin, f.begin + f.size);                     // throw
+                f.begin = nullptr;
+                f.offset = offset;
+            }
+        }
+        in_buffer_ = fields_.size();
+    }
+
+    // Makes the fields stored so far accessible through view()
+    void seal()
+    {
+        views_.reserve(fields_.size());                             // throw
+        for (const auto& f : fields_) {
+            views_.emplace_back(
+                f.begin ? f.begin : (value_.data() + f.offset), f.size);
+        }
+    }
+
+    record_view<view_type> view() const noexcept
+    {
+        return record_view<view_type>(
+            views_.data(), views_.data() + views_.size());
+    }
+};
+
 template <class TableSource, class Allocator>
 using primitive_for_t = primitive_table_pull<
         TableSource,
@@ -763,6 +1014,20 @@ private:
     using temporarily_discard =
         std::unique_ptr<primitive_t, reset_discarding_data>;
 
+    struct reset_batching_records
+    {
+        void operator()(primitive_t* p) const
+        {
+            p->set_batching_records(false);
+        }
+    };
+
+    using temporarily_batch =
+        std::unique_ptr<primitive_t, reset_batching_records>;
+
+public:
+    using record_view_type = detail::pull::record_view<view_type>;
+
 private:
     primitive_t p_;
     bool empty_physical_line_aware_;
@@ -770,10 +1035,12 @@ private:
     table_pull_state state_;
 
     // current string value, arranged contiguously, followed by a null
-    // character, and maintained also when value_ is in use
+    // character unless the buffer is const, and maintained also when value_
+    // is in use
     view_type view_;
-    // current string value, as a null terminated one, used only when it
-    // cannot reside in current buffer; empty when not used
+    // current string value, as a null terminated one unless the buffer is
+    // const, used only when it cannot reside in current buffer; empty when
+    // not used
     std::vector<char_type, Allocator> value_;
 
     // num of "end record" events encountered
@@ -781,6 +1048,9 @@ private:
     // num of "finalize" events encountered in current record
     std::size_t j_;
 
+    // fields read by next_record()
+    detail::pull::record_store<buffer_char_t, traits_type, Allocator> record_;
+
 public:
     static constexpr bool physical_position_available =
         primitive_t::physical_position_available;
@@ -807,7 +1077,8 @@ public:
             buffer_size),
         empty_physical_line_aware_(false),
         state_(table_pull_state::before_parse), view_(),
-        value_(alloc), i_(0), j_(0)
+        value_(alloc), i_(0), j_(0),
+        record_(alloc)
     {}
 
     table_pull(table_pull&& other) noexcept :
@@ -817,7 +1088,8 @@ public:
         view_(std::exchange(other.view_, view_type())),
         value_(std::move(other.value_)),
         i_(std::exchange(other.i_, 0)),
-        j_(std::exchange(other.j_, 0))
+        j_(std::exchange(other.j_, 0)),
+        record_(std::move(other.record_))
     {}
 
     ~table_pull() = default;
@@ -939,12 +1211,12 @@ private:
             case primitive_table_pull_state::finalize:
                 do_update(p_[0], p_[1]);                        // throw
                 if (value_.empty()) {
-                    if constexpr (!std::is_const_v<char_type>) {
+                    if constexpr (!std::is_const_v<buffer_char_t>) {
                         const_cast<char_type*>(view_.data())[view_.size()]
                             = char_type();
                     }
                 } else {
-                    if constexpr (std::is_const_v<char_type>) {
+                    if constexpr (std::is_const_v<buffer_char_t>) {
                         view_ = view_type(value_.data(), value_.size());
                     } else {
                         value_.push_back(char_type());          // throw
@@ -985,10 +1257,19 @@ private:
             value_.insert(value_.cend(), first, last);              // throw
         } else if (!view_.empty()) {
             const auto len = last - first;
-            traits_type::move(
-                const_cast<char_type*>(view_.data() + view_.size()),
-                first, len);
-            view_ = view_type(view_.data(), view_.size() + len);
+            if constexpr (std::is_const_v<buffer_char_t>) {
+                // We must not write into the buffer of the source, so the
+                // value has to be taken out of it
+                value_.reserve(view_.size() + len);                 // throw
+                value_.assign(view_.cbegin(), view_.cend());
+                value_.insert(value_.cend(), first, last);
+                view_ = view_type();
+            } else {
+                traits_type::move(
+                    const_cast<char_type*>(view_.data() + view_.size()),
+                    first, len);
+                view_ = view_type(view_.data(), view_.size() + len);
+            }
         } else {
             view_ = view_type(first, last - first);
         }
@@ -1033,6 +1314,12 @@ public:
                         ++i_;
                         j_ = 0;
                         --n;
+                        // The last record is left to the state machine
+                        // so that j_ is right
+                        const auto m = p_.skip_plain_records(
+                            n, empty_physical_line_aware_);
+                        i_ += m;
+                        n -= m;
                         break;
                     }
                 case primitive_table_pull_state::eof:
@@ -1049,6 +1336,72 @@ public:
         }
     }
 
+    table_pull& next_record()
+    {
+        if (!*this) {
+            return *this;
+        }
+
+        view_ = view_type();
+        value_.clear();
+        record_.clear();
+        switch (state_) {
+        case table_pull_state::field:
+            ++j_;
+            break;
+        case table_pull_state::record_end:
+            ++i_;
+            j_ = 0;
+            break;
+        default:
+            break;
+        }
+
+        // The parser is not suspended until the record ends, so that the
+        // loop below runs through the record in one go
+        p_.set_batching_records(true);
+        temporarily_batch b(&p_);
+        try {
+            for (;;) {
+                switch (p_().state()) {                             // throw
+                case primitive_table_pull_state::update:
+                    record_.update(p_[0], p_[1]);                   // throw
+                    break;
+                case primitive_table_pull_state::finalize:
+                    record_.finalize(p_[0], p_[1]);                 // throw
+                    ++j_;
+                    break;
+                case primitive_table_pull_state::empty_physical_line:
+                    if (!empty_physical_line_aware_) {
+                        break;
+                    }
+                    [[fallthrough]];
+                case primitive_table_pull_state::end_record:
+                    record_.seal();                                 // throw
+                    state_ = table_pull_state::record_end;
+                    return *this;
+                case primitive_table_pull_state::end_buffer:
+                    record_.evacuate();                             // throw
+                    break;
+                case primitive_table_pull_state::eof:
+                    record_.clear();
+                    state_ = table_pull_state::eof;
+                    return *this;
+                default:
+                    break;
+                }
+            }
+        } catch (...) {
+            state_ = table_pull_state::eof;
+            throw;
+        }
+    }
+
+    record_view_type record() const noexcept
+    {
+        return record_.view();
+    }
+
     const view_type& operator*() const noexcept
     {
         return view_;
@@ -12,7 +12,9 @@
 #include <memory>
 #include <new>
 #include <optional>
+#include <sstream>
 #include <string>
+#include <string_view>
 #include <typeinfo>
 #include <type_traits>
 #include <utility>
@@ -22,6 +24,8 @@
 #include "detail/buffer_size.hpp"
 #include "detail/member_like_base.hpp"
 #include "detail/typing_aid.hpp"
+#include "detail/write_ntmbs.hpp"
+#include "field_scanners.hpp"
 
 namespace commata {
 
@@ -302,6 +306,39 @@ class basic_table_scanner
         }
     };
 
+    // Resolves the bindings with the values of the first header record and
+    // forwards them to the header field scanner if any
+    struct binding_field_scanner : field_scanner
+    {
+        bool accepts_const() const noexcept override
+        {
+            return false;
+        }
+
+        void field_value(Ch* begin, Ch* end, basic_table_scanner& me) override
+        {
+            me.resolve_binding(begin, end);                         // throw
+            if (me.header_field_scanner_) {
+                me.header_field_scanner_->field_value(begin, end, me);
+            }
+        }
+
+        void field_value(const Ch*, const Ch*, basic_table_scanner&) override
+        {
+            // Never called because this does not accept const
+            assert(false);
+        }
+
+        void field_value(string_t&& value, basic_table_scanner& me) override
+        {
+            me.resolve_binding(
+                value.data(), value.data() + value.size());         // throw
+            if (me.header_field_scanner_) {
+                me.header_field_scanner_->field_value(std::move(value), me);
+            }
+        }
+    };
+
     using at_t = std::allocator_traits<Allocator>;
     using hfs_at_t =
         typename at_t::template rebind_traits<header_field_scanner>;
@@ -313,6 +350,17 @@ class basic_table_scanner
     using scanners_a_t = detail::allocation_only_allocator<bfs_ptr_p_a_t>;
     using res_at_t = typename at_t::template rebind_traits<record_end_scanner>;
 
+    struct binding
+    {
+        string_t name;
+        bfs_ptr_t scanner;      // null after installed
+        bool required;
+    };
+    using binding_a_t = typename at_t::template rebind_alloc<binding>;
+    using bindings_a_t = detail::allocation_only_allocator<binding_a_t>;
+
+    static constexpr std::size_t no_j = static_cast<std::size_t>(-1);
+
     std::size_t j_ = 0;
     const Ch* buffer_;
     const Ch* begin_;
@@ -320,10 +368,16 @@ class basic_table_scanner
     string_t value_;
     typename hfs_at_t::pointer header_field_scanner_;
     std::vector<bfs_ptr_p_t, scanners_a_t> scanners_;
-    typename std::vector<bfs_ptr_p_t, scanners_a_t>::size_type sj_;
+    typename std::vector<bfs_ptr_p_t, scanners_a_t>::size_type sj_ = 0;
         // possibly active scanner: can't be an iterator
         // because it would be invalidated by header scanners
+    std::size_t sj_j_ = no_j;
+        // field index of scanners_[sj_] or no_j, cached so that a field
+        // without a scanner is told by only one comparison
     typename res_at_t::pointer end_scanner_;
+    std::vector<binding, bindings_a_t> bindings_;
+        // sorted by names; not empty only until the first record ends
+    binding_field_scanner binder_;
 
 public:
     using char_type = const Ch;
@@ -357,7 +411,7 @@ public:
                         header_record_count) :
             nullptr),
         scanners_(scanners_a_t(bfs_ptr_p_a_t(alloc))),
-        end_scanner_(nullptr)
+        end_scanner_(nullptr), bindings_(bindings_a_t(binding_a_t(alloc)))
     {}
 
     template <class HeaderFieldScanner,
@@ -369,7 +423,8 @@ public:
         header_field_scanner_(allocate_construct<
             typed_header_field_scanner<std::decay_t<HeaderFieldScanner>>>(
                 std::forward<HeaderFieldScanner>(s))),
-        scanners_(scanners_a_t(bfs_ptr_p_a_t(alloc))), end_scanner_(nullptr)
+        scanners_(scanners_a_t(bfs_ptr_p_a_t(alloc))), end_scanner_(nullptr),
+        bindings_(bindings_a_t(binding_a_t(alloc)))
     {}
 
     basic_table_scanner(basic_table_scanner&& other) noexcept :
@@ -379,12 +434,14 @@ public:
         header_field_scanner_(std::exchange(other.header_field_scanner_,
                                             nullptr)),
         scanners_(std::move(other.scanners_)),
-        end_scanner_(std::exchange(other.end_scanner_, nullptr))
-    {}
+        end_scanner_(std::exchange(other.end_scanner_, nullptr)),
+        bindings_(std::move(other.bindings_))
+    {
+        sync_sj_j();
+    }
 
     ~basic_table_scanner()
     {
-        auto a = get_allocator();
         if (header_field_scanner_) {
             destroy_deallocate(header_field_scanner_);
         }
@@ -394,6 +451,11 @@ public:
         if (end_scanner_) {
             destroy_deallocate(end_scanner_);
         }
+        for (const auto& b : bindings_) {
+            if (b.scanner) {
+                destroy_deallocate(b.scanner);
+            }
+        }
     }
 
     allocator_type get_allocator() const noexcept
@@ -429,20 +491,27 @@ private:
             !std::is_base_of_v<std::nullptr_t, std::decay_t<FieldScanner>>>
     {
         using scanner_t = typed_body_field_scanner<std::decay_t<FieldScanner>>;
-        const auto it = std::lower_bound(
-            scanners_.begin(), scanners_.end(), j, scanner_less());
         const auto p = allocate_construct<scanner_t>(
                             std::forward<FieldScanner>(s));         // throw
+        try {
+            install_field_scanner(j, p);                            // throw
+        } catch (...) {
+            destroy_deallocate(p);
+            throw;
+        }
+    }
+
+    // Takes the ownership of p only when succeeded
+    void install_field_scanner(std::size_t j, bfs_ptr_t p)
+    {
+        const auto it = std::lower_bound(
+            scanners_.begin(), scanners_.end(), j, scanner_less());
         if ((it != scanners_.end()) && (it->second == j)) {
             destroy_deallocate(it->first);
             it->first = p;
         } else {
-            try {
-                scanners_.emplace(it, p, j);                        // throw
-            } catch (...) {
-                destroy_deallocate(p);
-                throw;
-            }
+            scanners_.emplace(it, p, j);                            // throw
+            sync_sj_j();
         }
     }
 
@@ -453,6 +522,7 @@ private:
         if ((it != scanners_.end()) && (it->second == j)) {
             destroy_deallocate(it->first);
             scanners_.erase(it);
+            sync_sj_j();
         }
     }
 
@@ -500,6 +570,109 @@ private:
         return nullptr;
     }
 
+public:
+    template <class FieldScanner>
+    void bind(std::basic_string_view<Ch, Tr> name, FieldScanner&& s,
+        bool required = true)
+    {
+        using scanner_t = typed_body_field_scanner<std::decay_t<FieldScanner>>;
+        const auto it = std::lower_bound(
+            bindings_.begin(), bindings_.end(), name, binding_less());
+        const auto p = allocate_construct<scanner_t>(
+                            std::forward<FieldScanner>(s));         // throw
+        if ((it != bindings_.end()) && (view(it->name) == name)) {
+            destroy_deallocate(it->scanner);
+            it->scanner = p;
+            it->required = required;
+        } else {
+            try {
+                bindings_.insert(it, binding{
+                    string_t(name, get_allocator()), p, required });
+                                                                    // throw
+            } catch (...) {
+                destroy_deallocate(p);
+                throw;
+            }
+        }
+    }
+
+private:
+    static std::basic_string_view<Ch, Tr> view(const string_t& s) noexcept
+    {
+        return std::basic_string_view<Ch, Tr>(s.data(), s.size());
+    }
+
+    struct binding_less
+    {
+        bool operator()(const binding& left,
+            std::basic_string_view<Ch, Tr> right) const noexcept
+        {
+            return view(left.name) < right;
+        }
+
+        bool operator()(std::basic_string_view<Ch, Tr> left,
+            const binding& right) const noexcept
+        {
+            return left < view(right.name);
+        }
+    };
+
+    void resolve_binding(const Ch* begin, const Ch* end)
+    {
+        const std::basic_string_view<Ch, Tr> name(begin, end - begin);
+        const auto it = std::lower_bound(
+            bindings_.begin(), bindings_.end(), name, binding_less());
+        // When the same name appears more than once, the first one wins
+        if ((it != bindings_.end()) && it->scanner
+         && (view(it->name) == name)) {
+            install_field_scanner(j_, it->scanner);                 // throw
+            it->scanner = nullptr;
+        }
+    }
+
+    void finish_binding()
+    {
+        std::optional<field_not_found> error;
+        for (const auto& b : bindings_) {
+            if (b.scanner && b.required) {
+                error.emplace(no_field_named());
+                break;
+            }
+        }
+        for (const auto& b : bindings_) {
+            if (b.scanner) {
+                destroy_deallocate(b.scanner);
+            }
+        }
+        bindings_.clear();
+        if (error) {
+            throw std::move(*error);
+        }
+    }
+
+    field_not_found no_field_named() const
+    {
+        using namespace std::string_view_literals;
+        constexpr auto what_core = "No field named "sv;
+        try {
+            std::ostringstream what;
+            what << what_core;
+            bool first = true;
+            for (const auto& b : bindings_) {
+                if (b.scanner && b.required) {
+                    what << (first ? "\"" : ", \"");
+                    detail::write_ntmbs(what, b.name.cbegin(), b.name.cend());
+                    what << '"';
+                    first = false;
+                }
+            }
+            what << " in the header";
+            return field_not_found(std::move(what).str());
+        } catch (...) {
+            return field_not_found("No required field in the header");
+        }
+    }
+
 public:
     template <class RecordEndScanner = std::nullptr_t>
     void set_record_end_scanner(RecordEndScanner&& s = RecordEndScanner())
@@ -584,6 +757,7 @@ public:
     void start_record(const Ch* /*record_begin*/)
     {
         sj_ = 0;
+        sync_sj_j();
         j_ = 0;
     }
 
@@ -640,6 +814,7 @@ private:
             finalize_core(first, last, *scanner.first);
             if (scanner.second) {
                 ++sj_;
+                sync_sj_j();
             }
         }
         ++j_;
@@ -688,8 +863,13 @@ private:
 public:
     bool end_record(const Ch* /*record_end*/)
     {
-        if (header_field_scanner_) {
-            header_field_scanner_->so_much_for_header(*this);
+        if (is_in_header()) {
+            if (!bindings_.empty()) {
+                finish_binding();                                   // throw
+            }
+            if (header_field_scanner_) {
+                header_field_scanner_->so_much_for_header(*this);
+            }
         } else {
             for (auto i = sj_, ie = scanners_.size(); i != ie; ++i) {
                 scanners_[i].first->field_skipped();
@@ -703,7 +883,7 @@ public:
 
     bool is_in_header() const noexcept
     {
-        return header_field_scanner_;
+        return header_field_scanner_ || !bindings_.empty();
     }
 
 private:
@@ -737,15 +917,22 @@ private:
 
     std::pair<field_scanner*, bool> get_scanner()
     {
-        if (header_field_scanner_) {
+        if (!bindings_.empty()) {
+            return { std::addressof(binder_), false };
+        } else if (header_field_scanner_) {
             return { std::addressof(*header_field_scanner_), false };
-        } else if ((sj_ < scanners_.size()) && (j_ == scanners_[sj_].second)) {
+        } else if (j_ == sj_j_) {
             return { std::addressof(*scanners_[sj_].first), true };
         } else {
             return { nullptr, false };
         }
     }
 
+    void sync_sj_j() noexcept
+    {
+        sj_j_ = (sj_ < scanners_.size()) ? scanners_[sj_].second : no_j;
+    }
+
     void remove_header_field_scanner(bool at_record_end)
     {
         if (at_record_end) {
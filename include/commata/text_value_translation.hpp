@@ -10,7 +10,9 @@
 #include <cassert>
 #include <cctype>
 #include <cerrno>
+#include <charconv>
 #include <clocale>
+#include <cmath>
 #include <cstdint>
 #include <cstdlib>
 #include <cwchar>
@@ -19,12 +21,15 @@
 #include <locale>
 #include <memory>
 #include <optional>
+#include <string>
 #include <string_view>
+#include <system_error>
 #include <type_traits>
 
 #include "field_handling.hpp"
 #include "text_error.hpp"
 
+#include "detail/decimal_digits.hpp"
 #include "detail/member_like_base.hpp"
 #include "detail/typing_aid.hpp"
 #include "detail/write_ntmbs.hpp"
@@ -230,9 +235,27 @@ private:
     }
 };
 
+#ifdef __cpp_lib_to_chars
+inline constexpr bool has_floating_point_from_chars = true;
+#else
+inline constexpr bool has_floating_point_from_chars = false;
+#endif
+
 template <class T>
-struct raw_converter
+class raw_converter
 {
+    // Both of the fast paths in from_chars take only '.' for the decimal
+    // point, whereas std::strtod and its comrades follow the current C
+    // locale, which is consulted only once here to keep it off the
+    // per-value path
+    bool period_is_decimal_point_;
+
+public:
+    raw_converter() :
+        period_is_decimal_point_(!std::is_floating_point_v<T>
+                              || (*std::localeconv()->decimal_point == '.'))
+    {}
+
     template <class Ch, class U, class H>
     auto operator()(
         const Ch* begin, const Ch* end, error_handler<U, H> h) const
@@ -242,18 +265,126 @@ struct raw_converter
         // For examble, when T is long, it is possible that U is int
         static_assert(std::is_convertible_v<U, T>);
 
+        T r;
+        if (from_chars(begin, end, r)) {
+            return r;
+        }
+
+        // Unusual inputs such as those with leading spaces, hexadecimal
+        // floating-point numbers and out-of-range values are left to
+        // std::strtol and its comrades, which need a null-terminated copy of
+        // [begin, end)
+        const auto length = static_cast<std::size_t>(end - begin);
+        if (length <= short_length) {
+            Ch s[short_length + 1];
+            std::char_traits<Ch>::copy(s, begin, length);
+            s[length] = Ch();
+            return strto(begin, end, s, h);
+        } else {
+            const std::basic_string<Ch> s(begin, end);
+            return strto(begin, end, s.c_str(), h);
+        }
+    }
+
+private:
+    static constexpr std::size_t short_length = 63;
+
+    // Succeeds only when [begin, end) has exactly what std::strtol and its
+    // comrades would take as a valid number without setting errno
+    bool from_chars(const char* begin, const char* end, T& r) const
+    {
+        if constexpr (std::is_integral_v<T>) {
+            // Plain numbers such as IDs and timestamps are most common
+            if (detail::digits::parse_integer(begin, end, r)) {
+                return true;
+            }
+        } else {
+            if (!period_is_decimal_point_) {
+                return false;
+            }
+            // Plain numbers such as prices and sensor values are most common
+            if (detail::digits::parse_floating_point(begin, end, r)) {
+                return true;
+            } else if constexpr (!has_floating_point_from_chars) {
+                return false;
+            }
+        }
+
+        if ((begin != end) && (*begin == '+')) {
+            ++begin;
+            if ((begin != end) && (*begin == '-')) {
+                return false;
+            }
+        }
+        if constexpr (std::is_unsigned_v<T>) {
+            // Negative numbers are wrapped around by std::strtoul
+            if ((begin != end) && (*begin == '-')) {
+                return false;
+            }
+        }
+
+        std::from_chars_result result;
+        if constexpr (std::is_floating_point_v<T>) {
+            result = std::from_chars(begin, end, r);
+        } else {
+            result = std::from_chars(begin, end, r, 10);
+        }
+        if (result.ec != std::errc()) {
+            return false;
+        }
+        if constexpr (std::is_floating_point_v<T>) {
+            // std::strtod and its comrades set ERANGE on subnormal results
+            if (std::fpclassify(r) == FP_SUBNORMAL) {
+                return false;
+            }
+        }
+        return std::all_of<const char*>(result.ptr, end, [](char c) {
+            return is_space(c);
+        });
+    }
+
+    bool from_chars(const wchar_t* begin, const wchar_t* end, T& r) const
+    {
+        // Numbers which std::wcstol and its comrades take consist of the
+        // basic source characters, so they can be narrowed losslessly
+        const auto length = static_cast<std::size_t>(end - begin);
+        if (length > short_length) {
+            return false;
+        }
+        // Zero-initialized lest GCC should warn that the chars past length
+        // may be read uninitialized
+        char s[short_length] = {};
+        for (std::size_t i = 0; i < length; ++i) {
+            const auto c =
+                static_cast<std::make_unsigned_t<wchar_t>>(begin[i]);
+            if (c > 0x7F) {
+                return false;
+            }
+            s[i] = static_cast<char>(c);
+        }
+        return from_chars(s, s + length, r);
+    }
+
+    // s shall be a null-terminated string which has the same contents as
+    // [begin, end)
+    template <class Ch, class U, class H>
+    static auto strto(const Ch* begin, const Ch* end, const Ch* s,
+        error_handler<U, H> h)
+     -> std::conditional_t<
+            error_handler<U, H>::template is_direct<Ch>, T, std::optional<T>>
+    {
         Ch* middle;
         errno = 0;
-        const T r = engine(begin, &middle);
+        const T r = engine(s, &middle);
 
         const auto has_postfix =
-            std::any_of<const Ch*>(middle, end, [](Ch c) {
+            std::any_of<const Ch*>(middle, s + (end - begin), [](Ch c) {
                 return !is_space(c);
             });
         if (has_postfix) {
             // if a not-whitespace-extra-character found, it is NG
             return h(invalid_format_t(), begin, end);
-        } else if (begin == middle) {
+        } else if (s == middle) {
             // whitespace only
             return h(empty_t());
         } else if (errno == ERANGE) {
@@ -308,15 +439,18 @@ private:
 };
 
 template <class T, class U>
-struct restrained_converter
+class restrained_converter
 {
+    raw_converter<U> raw_;
+
+public:
     template <class Ch, class H>
     auto operator()(
         const Ch* begin, const Ch* end, error_handler<T, H> h) const
      -> std::conditional_t<
             error_handler<U, H>::template is_direct<Ch>, T, std::optional<T>>
     {
-        const auto r = raw_converter<U>()(begin, end, h);
+        const auto r = raw_(begin, end, h);
         if constexpr (error_handler<U, H>::template is_direct<Ch>) {
             return restrain(r, begin, end, h);
         } else if (!r.has_value()) {
@@ -384,7 +518,6 @@ struct fail_if_conversion_failed
         const Ch* begin, const Ch* end, T* = nullptr) const
     try {
         using namespace std::string_view_literals;
-        assert(*end == Ch());
         std::stringbuf s;
         if constexpr (
                 std::is_same_v<Ch, char> || std::is_same_v<Ch, wchar_t>) {
@@ -407,7 +540,6 @@ struct fail_if_conversion_failed
         const Ch* begin, const Ch* end, int, T* = nullptr) const
     try {
         using namespace std::string_view_literals;
-        assert(*end == Ch());
         std::stringbuf s;
         if constexpr (
                 std::is_same_v<Ch, char> || std::is_same_v<Ch, wchar_t>) {
@@ -1162,12 +1294,13 @@ auto do_size(const A& a, ...) -> decltype(a->size())
 }
 
 template <class T, class A, class H>
-auto do_convert(const A& a, H&& h)
+auto do_convert(const A& a, H&& h,
+    const converter<std::remove_cv_t<T>>& c = converter<std::remove_cv_t<T>>())
 {
     const auto* const c_str = do_c_str(a);
     const auto size = do_size(a);
     using U = std::remove_cv_t<T>;
-    return converter<U>()(c_str, c_str + size, error_handler<U, H>(h));
+    return c(c_str, c_str + size, error_handler<U, H>(h));
 }
 
 struct is_default_translatable_arithmetic_type_impl
@@ -0,0 +1,166 @@
+/**
+ * These codes are licensed under the Unlicense.
+ * http://unlicense.org
+ */
+
+#ifndef COMMATA_GUARD_3C7D7044_C484_4AE2_89AF_145596BE6A70
+#define COMMATA_GUARD_3C7D7044_C484_4AE2_89AF_145596BE6A70
+
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <future>
+#include <ios>
+#include <iterator>
+#include <memory>
+#include <streambuf>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "csv_writer.hpp"
+#include "stored_table.hpp"
+
+#include "detail/vector_streambuf.hpp"
+
+namespace commata {
+namespace detail::table_writing {
+
+constexpr std::size_t default_chunk_size = static_cast<std::size_t>(1U << 20);
+
+// Returns the end of the records from first whose values amount to at least
+// chunk_size chars, and the number of chars of the CSV text of the records
+// as estimated from the lengths of the values
+template <class ForwardIterator>
+std::pair<ForwardIterator, std::size_t> chunk_end(
+    ForwardIterator first, ForwardIterator last, std::size_t chunk_size,
+    csv_quoting quoting, csv_line_terminator terminator) noexcept
+{
+    const std::size_t record_extra =
+        (terminator == csv_line_terminator::crlf) ? 2 : 1;
+    const std::size_t value_extra = (quoting == csv_quoting::all) ? 3 : 1;
+    std::size_t value_length = 0;
+    std::size_t length = 0;
+    for (; (first != last) && (value_length < chunk_size); ++first) {
+        for (const auto& value : *first) {
+            value_length += value.size();
+            length += value_extra;
+        }
+        length += record_extra;
+    }
+    return { first, value_length + length };
+}
+
+template <class Ch, class Tr, class Allocator, class ForwardIterator>
+std::vector<Ch, Allocator> format_chunk(
+    ForwardIterator first, ForwardIterator last, std::size_t length,
+    csv_quoting quoting, csv_line_terminator terminator,
+    const Allocator& alloc)
+{
+    vector_streambuf<Ch, Tr, Allocator> o(alloc);
+    o.reserve(length);                                              // throw
+    csv_writer<Ch, Tr, Allocator> w(std::allocator_arg, alloc, o,
+        quoting, terminator);                                       // throw
+    w.records(first, last);                                         // throw
+    w.flush();                                                      // throw
+    return o.release();
+}
+
+template <class Ch, class Tr>
+void write_out(std::basic_streambuf<Ch, Tr>& out,
+    const Ch* s, std::size_t n)
+{
+    if (static_cast<std::size_t>(out.sputn(
+            s, static_cast<std::streamsize>(n))) != n) {            // throw
+        throw std::ios_base::failure(
+            "Failed to write to the stream buffer");
+    }
+}
+
+} // end detail::table_writing
+
+template <class Allocator, class Content, class TableAllocator>
+void write_csv(std::allocator_arg_t, const Allocator& alloc,
+    const basic_stored_table<Content, TableAllocator>& table,
+    std::basic_streambuf<
+        typename basic_stored_table<Content, TableAllocator>::char_type,
+        typename basic_stored_table<Content, TableAllocator>::traits_type>&
+            out,
+    csv_quoting quoting = csv_quoting::minimal,
+    csv_line_terminator terminator = csv_line_terminator::lf,
+    std::size_t thread_count = 0, std::size_t chunk_size = 0)
+{
+    using table_t = basic_stored_table<Content, TableAllocator>;
+    using char_t = typename table_t::char_type;
+    using traits_t = typename table_t::traits_type;
+    using a_t = typename std::allocator_traits<Allocator>::
+        template rebind_alloc<char_t>;
+    using chunk_t = std::vector<char_t, a_t>;
+    using namespace detail::table_writing;
+
+    if (table.empty()) {
+        return;
+    }
+
+    const a_t a(alloc);
+    const auto& records = table.content();
+    auto i = std::cbegin(records);
+    const auto ie = std::cend(records);
+
+    if (thread_count == 0) {
+        thread_count = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+    if (chunk_size == 0) {
+        chunk_size = default_chunk_size;
+    }
+
+    if (thread_count == 1) {
+        csv_writer<char_t, traits_t, a_t> w(std::allocator_arg, a, out,
+            quoting, terminator);                                   // throw
+        w.records(i, ie);                                           // throw
+        w.flush();                                                  // throw
+        return;
+    }
+
+    // Chunks are cut by the lengths of the values rather than the numbers
+    // of the records so that the threads are given similar amounts of work
+    // however long the records are; at most thread_count chunks are in
+    // flight, and their outputs are written in the table order
+    std::deque<std::future<chunk_t>> results;
+    while ((i != ie) || !results.empty()) {
+        while ((i != ie) && (results.size() < thread_count)) {
+            const auto [e, length] =
+                chunk_end(i, ie, chunk_size, quoting, terminator);
+            results.push_back(std::async(std::launch::async,
+                [first = i, last = e, length = length,
+                 quoting, terminator, a] {
+                    return format_chunk<char_t, traits_t>(
+                        first, last, length, quoting, terminator, a);
+                }));                                                // throw
+            i = e;
+        }
+        const auto r = results.front().get();                       // throw
+        results.pop_front();
+        write_out(out, r.data(), r.size());                         // throw
+    }
+}
+
+template <class Content, class TableAllocator>
+void write_csv(const basic_stored_table<Content, TableAllocator>& table,
+    std::basic_streambuf<
+        typename basic_stored_table<Content, TableAllocator>::char_type,
+        typename basic_stored_table<Content, TableAllocator>::traits_type>&
+            out,
+    csv_quoting quoting = csv_quoting::minimal,
+    csv_line_terminator terminator = csv_line_terminator::lf,
+    std::size_t thread_count = 0, std::size_t chunk_size = 0)
+{
+    write_csv(std::allocator_arg,
+        std::allocator<
+            typename basic_stored_table<Content, TableAllocator>::char_type>(),
+        table, out, quoting, terminator, thread_count, chunk_size);
+}
+
+}
+
+#endif
@@ -0,0 +1,270 @@
+/**
+ * These codes are licensed under the Unlicense.
+ * http://unlicense.org
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <commata/column_buffer.hpp>
+#include <commata/field_scanners.hpp>
+#include <commata/parse_csv.hpp>
+#include <commata/table_scanner.hpp>
+#include <commata/text_error.hpp>
+#include <commata/text_value_translation.hpp>
+
+#include "BaseTest.hpp"
+#include "tracking_allocator.hpp"
+
+using namespace commata;
+using namespace commata::test;
+
+namespace {
+
+using Chs = testing::Types<char, wchar_t>;
+
+}
+
+struct TestColumnBuffer : BaseTest
+{};
+
+TEST_F(TestColumnBuffer, Basics)
+{
+    column_buffer<int> b;
+    ASSERT_TRUE(b.empty());
+    ASSERT_EQ(nullptr, b.validity_bitmap());
+
+    for (int i = 0; i < 10; ++i) {
+        b.push_back(i);
+    }
+    ASSERT_EQ(10U, b.size());
+    ASSERT_EQ(0U, b.null_count());
+    ASSERT_EQ(nullptr, b.validity_bitmap());
+    ASSERT_TRUE(b.is_valid(9));
+    ASSERT_EQ(7, b.data()[7]);
+
+    b.push_null();
+    b.push_back(11);
+    ASSERT_EQ(12U, b.size());
+    ASSERT_EQ(1U, b.null_count());
+    ASSERT_EQ(11, b[11]);
+    ASSERT_FALSE(b.is_valid(10));
+    ASSERT_TRUE(b.is_valid(11));
+
+    const std::uint8_t* const bitmap = b.validity_bitmap();
+    ASSERT_NE(nullptr, bitmap);
+    ASSERT_EQ(0xFFU, bitmap[0]);
+    ASSERT_EQ(0x0BU, bitmap[1]);    // 0b1011
+
+    b.clear();
+    ASSERT_TRUE(b.empty());
+    ASSERT_EQ(0U, b.null_count());
+    ASSERT_EQ(nullptr, b.validity_bitmap());
+}
+
+TEST_F(TestColumnBuffer, Growth)
+{
+    column_buffer<double> b;
+    b.push_null();
+    ASSERT_GE(b.capacity(), column_buffer<double>::min_bulk_capacity);
+
+    const std::size_t n = 3 * column_buffer<double>::min_bulk_capacity + 5;
+    for (std::size_t i = 1; i < n; ++i) {
+        if (i % 3 == 0) {
+            b.push_null();
+        } else {
+            b.push_back(static_cast<double>(i));
+        }
+    }
+    ASSERT_EQ(n, b.size());
+    ASSERT_EQ(n / 3 + 1, b.null_count());
+    for (std::size_t i = 0; i < n; ++i) {
+        ASSERT_EQ(i % 3 != 0, b.is_valid(i)) << i;
+        if (i % 3 != 0) {
+            ASSERT_EQ(static_cast<double>(i), b[i]) << i;
+        }
+    }
+}
+
+TEST_F(TestColumnBuffer, FieldTranslator)
+{
+    column_buffer<int> values0;
+    column_buffer<double> values1;
+
+    basic_table_scanner<char> h(1U);
+    h.set_field_scanner(0, make_field_translator(values0, replacement_ignore,
+        replace_if_conversion_failed<int>(
+            replacement_ignore, replacement_ignore)));
+    h.set_field_scanner(1,
+        make_field_translator(values1, replace_if_skipped(-1.0)));
+
+    std::stringstream s;
+    s << "A,B\n"
+         "10,0.5\n"
+         "xyz,1.5\n"
+         ",2.5\n"
+         "40\n";
+    try {
+        parse_csv(s, std::move(h));
+    } catch (const text_error& e) {
+        FAIL() << text_error_info(e);
+    }
+
+    ASSERT_EQ(4U, values0.size());
+    ASSERT_EQ(2U, values0.null_count());
+    ASSERT_EQ(10, values0[0]);
+    ASSERT_FALSE(values0.is_valid(1));
+    ASSERT_FALSE(values0.is_valid(2));
+    ASSERT_EQ(40, values0[3]);
+    ASSERT_EQ(0x09U, values0.validity_bitmap()[0]);   // 0b1001
+
+    ASSERT_EQ(4U, values1.size());
+    ASSERT_EQ(0U, values1.null_count());
+    ASSERT_EQ(-1.0, values1[3]);
+}
+
+TEST_F(TestColumnBuffer, FieldTranslatorFails)
+{
+    column_buffer<int> values;
+    auto t = make_field_translator(values);
+    std::string s = "12";
+    t(s.data(), s.data() + s.size());
+    ASSERT_EQ(1U, values.size());
+    s = "x";
+    ASSERT_THROW(t(s.data(), s.data() + s.size()), text_value_invalid_format);
+    ASSERT_THROW(t(), field_not_found);
+    ASSERT_EQ(1U, values.size());
+}
+
+TEST_F(TestColumnBuffer, Allocator)
+{
+    using alloc_t = tracking_allocator<std::allocator<long>>;
+
+    std::vector<std::pair<char*, char*>> allocated;
+    std::size_t total = 0U;
+    alloc_t a(allocated, total);
+
+    column_buffer<long, alloc_t> b(a);
+    ASSERT_EQ(a, b.get_allocator());
+    b.push_back(1);
+    b.push_null();
+    constexpr auto n = column_buffer<long, alloc_t>::min_bulk_capacity;
+    ASSERT_GE(total, n * sizeof(long) + n / 8);
+    ASSERT_TRUE(a.tracks(reinterpret_cast<const char*>(b.data())));
+    ASSERT_TRUE(a.tracks(
+        reinterpret_cast<const char*>(b.validity_bitmap())));
+}
+
+template <class Ch>
+struct TestStringColumnBuffer : BaseTest
+{};
+
+TYPED_TEST_SUITE(TestStringColumnBuffer, Chs);
+
+TYPED_TEST(TestStringColumnBuffer, Basics)
+{
+    using string_view_t = std::basic_string_view<TypeParam>;
+
+    const auto str = char_helper<TypeParam>::str;
+
+    basic_string_column_buffer<TypeParam> b;
+    ASSERT_TRUE(b.empty());
+    ASSERT_EQ(0, b.offsets()[0]);
+
+    b.push_back(str("abc"));
+    b.push_back(string_view_t());
+    b.push_null();
+    b.push_back(str("de"));
+    ASSERT_EQ(4U, b.size());
+    ASSERT_EQ(5U, b.data_size());
+    ASSERT_EQ(1U, b.null_count());
+
+    const std::int32_t expected_offsets[] = { 0, 3, 3, 3, 5 };
+    ASSERT_TRUE(std::equal(std::begin(expected_offsets),
+        std::end(expected_offsets), b.offsets()));
+    ASSERT_EQ(str("abcde"), string_view_t(b.data(), b.data_size()));
+    ASSERT_EQ(str("de"), b[3]);
+    ASSERT_TRUE(b.is_valid(1));
+    ASSERT_FALSE(b.is_valid(2));
+    ASSERT_EQ(0x0BU, b.validity_bitmap()[0]);   // 0b1011
+
+    b.clear();
+    ASSERT_TRUE(b.empty());
+    ASSERT_EQ(0, b.offsets()[0]);
+    ASSERT_EQ(nullptr, b.validity_bitmap());
+}
+
+struct TestRecordBatchEmitter : BaseTest
+{};
+
+TEST_F(TestRecordBatchEmitter, StringColumns)
+{
+    struct batch_t
+    {
+        std::size_t record_count;
+        std::vector<std::int32_t> offsets;
+        std::string data;
+        std::size_t null_count;
+        std::vector<long> values;
+    };
+    std::vector<batch_t> batches;
+
+    string_column_buffer names;
+    column_buffer<long> values;
+    auto emitter = make_record_batch_emitter(2U,
+        [&batches](std::size_t n,
+                   const string_column_buffer& names,
+                   const column_buffer<long>& values) {
+            batches.push_back({ n,
+                std::vector<std::int32_t>(
+                    names.offsets(), names.offsets() + n + 1),
+                std::string(names.data(), names.data_size()),
+                names.null_count(),
+                std::vector<long>(values.begin(), values.end()) });
+        }, names, values);
+
+    table_scanner h(1U);
+    h.set_field_scanner(0, make_field_translator(names, replacement_ignore));
+    h.set_field_scanner(1,
+        make_field_translator(values, replace_if_skipped(0L)));
+    h.set_record_end_scanner(std::ref(emitter));
+
+    std::stringstream s;
+    s << "name,value\n"
+         "ab,1\n"
+         "c,2\n"
+         "def\n"
+         "\n"      // empty lines are not records
+         "g,4\n"
+         "hi,5\n";
+    try {
+        parse_csv(s, std::move(h));
+    } catch (const text_error& e) {
+        FAIL() << text_error_info(e);
+    }
+    ASSERT_EQ(1U, emitter.record_count());
+    emitter.flush();
+    ASSERT_EQ(0U, emitter.record_count());
+    ASSERT_TRUE(names.empty());
+    ASSERT_TRUE(values.empty());
+
+    ASSERT_EQ(3U, batches.size());
+    ASSERT_EQ(2U, batches[0].record_count);
+    ASSERT_EQ((std::vector<std::int32_t>{ 0, 2, 3 }), batches[0].offsets);
+    ASSERT_EQ("abc", batches[0].data);
+    ASSERT_EQ((std::vector<long>{ 1, 2 }), batches[0].values);
+    ASSERT_EQ((std::vector<std::int32_t>{ 0, 3, 4 }), batches[1].offsets);
+    ASSERT_EQ("defg", batches[1].data);
+    ASSERT_EQ((std::vector<long>{ 0, 4 }), batches[1].values);
+    ASSERT_EQ(1U, batches[2].record_count);
+    ASSERT_EQ("hi", batches[2].data);
+}
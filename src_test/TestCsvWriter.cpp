@@ -0,0 +1,205 @@
+/**
+ * These codes are licensed under the Unlicense.
+ * http://unlicense.org
+ */
+
+#include <cstddef>
+#include <ios>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <commata/csv_writer.hpp>
+#include <commata/parse_csv.hpp>
+
+#include "BaseTest.hpp"
+#include "tracking_allocator.hpp"
+
+using namespace commata;
+using namespace commata::test;
+
+namespace {
+
+using Chs = testing::Types<char, wchar_t>;
+
+template <class Ch>
+class test_collector
+{
+    std::vector<std::vector<std::basic_string<Ch>>>* field_values_;
+    std::basic_string<Ch> field_value_;
+
+public:
+    using char_type = Ch;
+
+    explicit test_collector(
+        std::vector<std::vector<std::basic_string<Ch>>>& field_values) :
+        field_values_(&field_values)
+    {}
+
+    void start_record(const Ch* /*record_begin*/)
+    {
+        field_values_->emplace_back();
+    }
+
+    void update(const Ch* first, const Ch* last)
+    {
+        field_value_.append(first, last);
+    }
+
+    void finalize(const Ch* first, const Ch* last)
+    {
+        field_value_.append(first, last);
+        field_values_->back().emplace_back();
+        field_values_->back().back().swap(field_value_);
+    }
+
+    void end_record(const Ch* /*record_end*/)
+    {}
+};
+
+// Fails to accept chars after some amount of them
+class short_stringbuf : public std::stringbuf
+{
+    std::streamsize rest_;
+
+public:
+    explicit short_stringbuf(std::streamsize rest) :
+        rest_(rest)
+    {}
+
+protected:
+    std::streamsize xsputn(const char* s, std::streamsize n) override
+    {
+        const auto m = std::min(n, rest_);
+        rest_ -= m;
+        return std::stringbuf::xsputn(s, m);
+    }
+};
+
+}
+
+template <class Ch>
+struct TestCsvWriter : BaseTest
+{};
+
+TYPED_TEST_SUITE(TestCsvWriter, Chs);
+
+TYPED_TEST(TestCsvWriter, Basics)
+{
+    const auto str = char_helper<TypeParam>::str;
+
+    std::basic_stringbuf<TypeParam> out;
+    {
+        csv_writer w(out);
+        w.record(str("name"), str("value"));
+        w.field(str("a,b")).field(-12).end_record();
+        w.record(str("say \"hi\""), 0.5);
+        w.record(str("x\r\ny"), str(""));
+        w.record(str(""));
+        w.record(str(" c "), 18446744073709551615ULL);
+    }
+    ASSERT_EQ(str("name,value\n"
+                  "\"a,b\",-12\n"
+                  "\"say \"\"hi\"\"\",0.5\n"
+                  "\"x\r\ny\",\n"
+                  "\"\"\n"
+                  " c ,18446744073709551615\n"),
+              out.str());
+}
+
+TYPED_TEST(TestCsvWriter, Dialect)
+{
+    const auto str = char_helper<TypeParam>::str;
+
+    std::basic_stringbuf<TypeParam> out;
+    csv_writer w(out, csv_quoting::all, csv_line_terminator::crlf);
+    w.record(str("a"), 1, str("\"")).record(str(""));
+    w.flush();
+    ASSERT_EQ(str("\"a\",\"1\",\"\"\"\"\r\n\"\"\r\n"), out.str());
+}
+
+TYPED_TEST(TestCsvWriter, RoundTrip)
+{
+    using string_t = std::basic_string<TypeParam>;
+
+    const auto str = char_helper<TypeParam>::str;
+
+    std::vector<std::vector<string_t>> table;
+    for (int i = 0; i < 200; ++i) {
+        const auto n = char_helper<TypeParam>::to_string(i);
+        table.push_back({ n, string_t(i % 7, TypeParam('"')) + n,
+                          str("p,q\r") + n, string_t(),
+                          string_t(i * 3, TypeParam('z')) });
+    }
+    table.push_back({ string_t() });
+
+    for (const auto quoting : { csv_quoting::minimal, csv_quoting::all }) {
+        for (const auto terminator : { csv_line_terminator::lf,
+                                       csv_line_terminator::crlf }) {
+            for (const std::size_t buffer_size : { 1, 5, 0 }) {
+                std::basic_stringbuf<TypeParam> out;
+                csv_writer(out, quoting, terminator, buffer_size)
+                    .records(table.cbegin(), table.cend());
+                std::vector<std::vector<string_t>> read;
+                parse_csv(out.str(), test_collector<TypeParam>(read));
+                ASSERT_EQ(table, read) << buffer_size;
+            }
+        }
+    }
+}
+
+TYPED_TEST(TestCsvWriter, Numbers)
+{
+    const auto str = char_helper<TypeParam>::str;
+
+    std::basic_stringbuf<TypeParam> out;
+    csv_writer(out).record(0.1, -2.5e-30F, 1e300,
+        std::numeric_limits<long long>::min(), static_cast<short>(7));
+    std::vector<std::vector<std::basic_string<TypeParam>>> read;
+    parse_csv(out.str(), test_collector<TypeParam>(read));
+    ASSERT_EQ(1U, read.size());
+    ASSERT_EQ(5U, read[0].size());
+    ASSERT_EQ(str("0.1"), read[0][0]);
+    ASSERT_EQ(0.1, std::stod(read[0][0]));
+    ASSERT_EQ(-2.5e-30F, std::stof(read[0][1]));
+    ASSERT_EQ(1e300, std::stod(read[0][2]));
+    ASSERT_EQ(char_helper<TypeParam>::to_string(
+                std::numeric_limits<long long>::min()), read[0][3]);
+    ASSERT_EQ(str("7"), read[0][4]);
+}
+
+TYPED_TEST(TestCsvWriter, Allocator)
+{
+    using alloc_t = tracking_allocator<std::allocator<TypeParam>>;
+
+    const auto str = char_helper<TypeParam>::str;
+
+    std::vector<std::pair<char*, char*>> allocated;
+    std::size_t total = 0U;
+    alloc_t a(allocated, total);
+    std::basic_stringbuf<TypeParam> out;
+    {
+        csv_writer w(std::allocator_arg, a, out);
+        ASSERT_EQ(a, w.get_allocator());
+        ASSERT_GT(total, 0U);
+        w.record(str("a"));
+    }
+    ASSERT_TRUE(allocated.empty());
+    ASSERT_EQ(str("a\n"), out.str());
+}
+
+struct TestCsvWriterMiscellaneous : BaseTest
+{};
+
+TEST_F(TestCsvWriterMiscellaneous, Failure)
+{
+    short_stringbuf out(10);
+    csv_writer w(out, csv_quoting::minimal, csv_line_terminator::lf, 4);
+    w.record("abc");
+    ASSERT_THROW(w.record("defghijklmn"), std::ios_base::failure);
+}
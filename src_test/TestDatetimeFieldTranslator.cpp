@@ -0,0 +1,190 @@
+/**
+ * These codes are licensed under the Unlicense.
+ * http://unlicense.org
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <commata/datetime_field_translator.hpp>
+#include <commata/parse_csv.hpp>
+#include <commata/table_scanner.hpp>
+#include <commata/text_error.hpp>
+#include <commata/text_value_translation.hpp>
+
+#include "BaseTest.hpp"
+
+using namespace commata;
+using namespace commata::test;
+
+namespace {
+
+using Chs = testing::Types<char, wchar_t>;
+
+template <class Duration>
+using sys_time_t =
+    std::chrono::time_point<std::chrono::system_clock, Duration>;
+
+using sys_seconds_t = sys_time_t<std::chrono::seconds>;
+using sys_milliseconds_t = sys_time_t<std::chrono::milliseconds>;
+using sys_nanoseconds_t = sys_time_t<std::chrono::nanoseconds>;
+
+template <class T>
+T at(std::int64_t count)
+{
+    return T(typename T::duration(count));
+}
+
+}
+
+template <class Ch>
+struct TestDatetimeFieldTranslator : BaseTest
+{
+    template <class Translator>
+    static void translate(Translator& t, const char* s)
+    {
+        const auto v = char_helper<Ch>::str(s);
+        t(v.data(), v.data() + v.size());
+    }
+};
+
+TYPED_TEST_SUITE(TestDatetimeFieldTranslator, Chs);
+
+TYPED_TEST(TestDatetimeFieldTranslator, Iso8601)
+{
+    std::vector<sys_milliseconds_t> values;
+    auto t = make_datetime_field_translator(values);
+    static_assert(std::is_same_v<datetime_format::iso8601,
+                                 typename decltype(t)::format_type>);
+
+    this->translate(t, "1970-01-01");
+    this->translate(t, "2000-02-29T12:34:56Z");
+    this->translate(t, "2000-02-29t12:34:56.789z");
+    this->translate(t, "2000-02-29T21:34:56.7891+09:00");
+    this->translate(t, "2000-02-29T07:04:56-0530");
+    this->translate(t, " 1969-12-31T23:59:59.5 ");
+
+    const std::int64_t s = 951827696;   // 2000-02-29T12:34:56Z
+    ASSERT_EQ((std::vector<sys_milliseconds_t>{
+                at<sys_milliseconds_t>(0),
+                at<sys_milliseconds_t>(s * 1000),
+                at<sys_milliseconds_t>(s * 1000 + 789),
+                at<sys_milliseconds_t>(s * 1000 + 789),
+                at<sys_milliseconds_t>(s * 1000),
+                at<sys_milliseconds_t>(-500) }), values);
+}
+
+TYPED_TEST(TestDatetimeFieldTranslator, YmdHms)
+{
+    std::vector<sys_nanoseconds_t> values;
+    auto t = make_datetime_field_translator<datetime_format::ymd_hms>(values);
+
+    this->translate(t, "2023-03-01 00:00:00");
+    this->translate(t, "1900-01-01 00:00:00.000000001");
+    this->translate(t, "2262-04-11 23:47:16.854775807");
+
+    ASSERT_EQ((std::vector<sys_nanoseconds_t>{
+                at<sys_nanoseconds_t>(1677628800LL * 1000000000),
+                at<sys_nanoseconds_t>(-2208988800LL * 1000000000 + 1),
+                at<sys_nanoseconds_t>(9223372036854775807LL) }), values);
+
+    // One nanosecond beyond the max
+    ASSERT_THROW(this->translate(t, "2262-04-11 23:47:16.854775808"),
+        text_value_out_of_range);
+    for (const auto s : { "2023-02-29 00:00:00", "2023-13-01 00:00:00",
+                          "2023-01-01 24:00:00", "2023-01-01T00:00:00",
+                          "2023-01-01 00:00:00.", "2023-01-01 00:00:00Z",
+                          "2023-1-01 00:00:00", "2023-01-01" }) {
+        ASSERT_THROW(this->translate(t, s), text_value_invalid_format) << s;
+    }
+    ASSERT_THROW(this->translate(t, " "), text_value_empty);
+    ASSERT_THROW(t(), field_not_found);
+    ASSERT_EQ(3U, values.size());
+}
+
+TYPED_TEST(TestDatetimeFieldTranslator, Epoch)
+{
+    std::vector<sys_seconds_t> values1;
+    auto t1 = make_datetime_field_translator<datetime_format::epoch_seconds>(
+        values1);
+    this->translate(t1, "1700000000");
+    this->translate(t1, "-86400");
+    this->translate(t1, "+0");
+    ASSERT_EQ((std::vector<sys_seconds_t>{
+                at<sys_seconds_t>(1700000000),
+                at<sys_seconds_t>(-86400),
+                at<sys_seconds_t>(0) }), values1);
+    ASSERT_THROW(this->translate(t1, "12a"), text_value_invalid_format);
+    ASSERT_THROW(this->translate(t1, "-"), text_value_invalid_format);
+    ASSERT_THROW(this->translate(t1, "-1234567890123456789"),
+        text_value_out_of_range);
+
+    std::vector<sys_milliseconds_t> values2;
+    auto t2 = make_datetime_field_translator<
+        sys_milliseconds_t, datetime_format::epoch_milliseconds>(
+            [&values2](sys_milliseconds_t v) { values2.push_back(v); });
+    this->translate(t2, "1700000000123");
+    this->translate(t2, "-1");
+    ASSERT_EQ((std::vector<sys_milliseconds_t>{
+                at<sys_milliseconds_t>(1700000000123),
+                at<sys_milliseconds_t>(-1) }), values2);
+
+    // Floored to seconds
+    std::vector<sys_seconds_t> values3;
+    auto t3 = make_datetime_field_translator<
+        datetime_format::epoch_milliseconds>(values3);
+    this->translate(t3, "-1");
+    ASSERT_EQ(at<sys_seconds_t>(-1), values3.at(0));
+}
+
+TYPED_TEST(TestDatetimeFieldTranslator, Handlers)
+{
+    const auto replacement = at<sys_seconds_t>(42);
+
+    std::vector<sys_seconds_t> values;
+    auto t = make_datetime_field_translator(values,
+        replace_if_skipped(replacement),
+        replace_if_conversion_failed<sys_seconds_t>(
+            replacement_ignore, replacement));
+    t();
+    this->translate(t, "");
+    this->translate(t, "yesterday");
+    ASSERT_EQ((std::vector<sys_seconds_t>{ replacement, replacement }),
+              values);
+
+    std::vector<sys_seconds_t> values2;
+    auto t2 = make_datetime_field_translator(values2,
+        replacement_ignore, replacement_ignore);
+    t2();
+    this->translate(t2, "2000-01-01T00:00:00+24:00");
+    ASSERT_TRUE(values2.empty());
+}
+
+TYPED_TEST(TestDatetimeFieldTranslator, TableScanner)
+{
+    const auto str = char_helper<TypeParam>::str;
+
+    std::vector<sys_seconds_t> values;
+    basic_table_scanner<TypeParam> h(1U);
+    h.set_field_scanner(1, make_datetime_field_translator<
+        datetime_format::ymd_hms>(values));
+
+    std::basic_stringstream<TypeParam> s;
+    s << str("id,timestamp\n"
+             "1,2001-09-09 01:46:40\n"
+             "2,\"2001-09-09 01:46:41\"\n");
+    try {
+        parse_csv(s, std::move(h), 8U);
+    } catch (const text_error& e) {
+        FAIL() << text_error_info(e);
+    }
+    ASSERT_EQ((std::vector<sys_seconds_t>{
+                at<sys_seconds_t>(1000000000),
+                at<sys_seconds_t>(1000000001) }), values);
+}
@@ -0,0 +1,189 @@
+/**
+ * These codes are licensed under the Unlicense.
+ * http://unlicense.org
+ */
+
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <commata/field_value_set.hpp>
+#include <commata/parse_csv.hpp>
+#include <commata/record_extractor.hpp>
+
+#include "BaseTest.hpp"
+#include "tracking_allocator.hpp"
+
+using namespace commata;
+using namespace commata::test;
+
+namespace {
+
+using Chs = testing::Types<char, wchar_t>;
+
+}
+
+template <class Ch>
+struct TestFieldValueSet : BaseTest
+{};
+
+TYPED_TEST_SUITE(TestFieldValueSet, Chs);
+
+TYPED_TEST(TestFieldValueSet, Basics)
+{
+    using string_t = std::basic_string<TypeParam>;
+
+    const auto str = char_helper<TypeParam>::str;
+
+    std::vector<string_t> values;
+    for (int i = 0; i < 1000; i += 3) {
+        values.push_back(char_helper<TypeParam>::to_string(i));
+    }
+    values.push_back(str("6"));         // duplicate
+    values.emplace_back();
+
+    const field_value_set s(values.cbegin(), values.cend());
+    ASSERT_EQ(values.size() - 1, s.size());
+    for (int i = 0; i < 1000; ++i) {
+        ASSERT_EQ(i % 3 == 0, s(char_helper<TypeParam>::to_string(i))) << i;
+    }
+    ASSERT_TRUE(s(string_t()));
+    ASSERT_FALSE(s(str("06")));
+    ASSERT_FALSE(s(str("9999")));
+
+    const field_value_set<TypeParam> e({});
+    ASSERT_EQ(0U, e.size());
+    ASSERT_FALSE(e(string_t()));
+}
+
+TYPED_TEST(TestFieldValueSet, Incremental)
+{
+    const auto str = char_helper<TypeParam>::str;
+
+    field_value_set<TypeParam> s({ str("abc"), str("de") },
+                                 incremental_hashing::yes);
+    ASSERT_TRUE(s.is_incremental());
+
+    const auto abc = str("abc");
+    s.update_value(abc.data(), abc.data() + 1);
+    s.update_value(abc.data() + 1, abc.data() + 1);
+    ASSERT_TRUE(s.finalize_value(abc.data() + 1, abc.data() + 3));
+    s.update_value(abc.data(), abc.data() + 2);
+    ASSERT_FALSE(s.finalize_value(abc.data() + 2, abc.data() + 2));
+    ASSERT_TRUE(s.finalize_value(abc.data(), abc.data() + 3));
+}
+
+TYPED_TEST(TestFieldValueSet, IncrementalExact)
+{
+    using string_t = std::basic_string<TypeParam>;
+
+    const auto str = char_helper<TypeParam>::str;
+
+    field_value_set<TypeParam> s({ str("abc"), str("abd"), str("de") },
+                                 incremental_hashing::yes);
+
+    // Find a non-member which has the same length as a member and which
+    // shares a slot of the hash table, which has eight slots, with it
+    const auto slot_of = [](const string_t& v) {
+        using namespace detail::value_set;
+        return slot_index(hash(hash_basis, v.data(), v.data() + v.size()), 7);
+    };
+    const string_t abc = str("abc");
+    string_t v;
+    for (TypeParam c = 'e'; c <= 'z'; ++c) {
+        for (TypeParam d = 'a'; d <= 'z'; ++d) {
+            const string_t w = { c, d, abc[2] };
+            if (slot_of(w) == slot_of(abc)) {
+                v = w;
+                break;
+            }
+        }
+        if (!v.empty()) {
+            break;
+        }
+    }
+    ASSERT_FALSE(v.empty());
+    ASSERT_FALSE(s(v));
+    s.update_value(v.data(), v.data() + 1);
+    ASSERT_FALSE(s.finalize_value(v.data() + 1, v.data() + 3));
+
+    const auto abd = str("abd");
+    s.update_value(abd.data(), abd.data() + 1);
+    ASSERT_TRUE(s.finalize_value(abd.data() + 1, abd.data() + 3));
+    s.update_value(abc.data(), abc.data() + 1);
+    ASSERT_FALSE(s.finalize_value(abc.data() + 1, abc.data() + 2));
+
+    const auto abde = str("abde");
+    s.update_value(abde.data(), abde.data() + 2);
+    s.update_value(abde.data() + 2, abde.data() + 3);
+    ASSERT_FALSE(s.finalize_value(abde.data() + 3, abde.data() + 4));
+    s.update_value(abde.data() + 2, abde.data() + 3);
+    ASSERT_TRUE(s.finalize_value(abde.data() + 3, abde.data() + 4));
+}
+
+TYPED_TEST(TestFieldValueSet, RecordExtractor)
+{
+    const auto str = char_helper<TypeParam>::str;
+
+    std::basic_string<TypeParam> csv = str("id,name\n");
+    for (int i = 0; i < 300; ++i) {
+        const auto id = char_helper<TypeParam>::to_string(i * 7);
+        csv += ((i % 2 == 0) ? id : (str("\"") + id + str("\"\"\""))) +
+               str(",n") + id + str("\n");
+    }
+    std::vector<std::basic_string<TypeParam>> ids;
+    for (int i = 0; i < 2100; i += 5) {
+        ids.push_back(char_helper<TypeParam>::to_string(i));
+    }
+    ids.push_back(str("7\""));
+
+    std::basic_stringbuf<TypeParam> expected;
+    parse_csv(csv, make_record_extractor(expected, str("id"),
+        [&ids](std::basic_string_view<TypeParam> v) {
+            for (const auto& id : ids) {
+                if (id == v) {
+                    return true;
+                }
+            }
+            return false;
+        }));
+    ASSERT_NE(std::basic_string<TypeParam>::npos,
+              expected.str().find(str("\"7\"\"\",n7\n")));
+
+    for (const auto hashing : { incremental_hashing::no,
+                                incremental_hashing::yes }) {
+        const field_value_set s(ids.cbegin(), ids.cend(), hashing);
+        for (const std::size_t buffer_size : { 1, 2, 5, 1024 }) {
+            std::basic_stringbuf<TypeParam> out;
+            parse_csv(csv, make_record_extractor(out, str("id"), s),
+                buffer_size);
+            ASSERT_EQ(expected.str(), out.str()) << buffer_size;
+        }
+    }
+}
+
+TYPED_TEST(TestFieldValueSet, Allocator)
+{
+    using alloc_t = tracking_allocator<std::allocator<TypeParam>>;
+
+    const auto str = char_helper<TypeParam>::str;
+
+    std::vector<std::pair<char*, char*>> allocated;
+    std::size_t total = 0U;
+    alloc_t a(allocated, total);
+    {
+        const std::vector<std::basic_string<TypeParam>> values = {
+            str("x"), str("y") };
+        const field_value_set s(std::allocator_arg, a,
+                                values.cbegin(), values.cend());
+        ASSERT_GT(total, 0U);
+        ASSERT_EQ(a, s.get_allocator());
+        const auto s2 = s;
+        ASSERT_TRUE(s2(str("y")));
+    }
+    ASSERT_TRUE(allocated.empty());
+}
@@ -0,0 +1,224 @@
+/**
+ * These codes are licensed under the Unlicense.
+ * http://unlicense.org
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <commata/field_scanners.hpp>
+#include <commata/monotonic_arena.hpp>
+#include <commata/parse_csv.hpp>
+#include <commata/stored_table.hpp>
+#include <commata/table_pull.hpp>
+#include <commata/table_scanner.hpp>
+
+#include "BaseTest.hpp"
+
+using namespace commata;
+using namespace commata::test;
+
+namespace {
+
+class counting_resource : public std::pmr::memory_resource
+{
+    std::size_t allocated_;
+    std::size_t count_;
+
+public:
+    counting_resource() : allocated_(0), count_(0)
+    {}
+
+    std::size_t allocated() const
+    {
+        return allocated_;
+    }
+
+    std::size_t count() const
+    {
+        return count_;
+    }
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        const auto p = std::pmr::new_delete_resource()->
+            allocate(bytes, alignment);
+        allocated_ += bytes;
+        ++count_;
+        return p;
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment)
+        override
+    {
+        allocated_ -= bytes;
+        --count_;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other)
+        const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+}
+
+struct TestMonotonicArena : BaseTest
+{};
+
+TEST_F(TestMonotonicArena, Basics)
+{
+    counting_resource upstream;
+    {
+        monotonic_arena arena(256, &upstream);
+        ASSERT_EQ(&upstream, arena.upstream_resource());
+        ASSERT_EQ(0U, upstream.count());
+
+        const auto p1 = static_cast<char*>(arena.allocate(3, 1));
+        const auto p2 = arena.allocate(8, 8);
+        ASSERT_EQ(1U, upstream.count());
+        ASSERT_EQ(upstream.allocated(), arena.upstream_total());
+        ASSERT_EQ(0U, reinterpret_cast<std::uintptr_t>(p2) % 8);
+        ASSERT_LE(p1 + 3, p2);
+
+        // Exceeds the first chunk
+        const auto p3 = arena.allocate(1000, 64);
+        ASSERT_EQ(2U, upstream.count());
+        ASSERT_EQ(0U, reinterpret_cast<std::uintptr_t>(p3) % 64);
+        arena.deallocate(p3, 1000, 64);
+        ASSERT_EQ(2U, upstream.count());
+
+        arena.release();
+        ASSERT_EQ(0U, upstream.count());
+        ASSERT_EQ(0U, arena.upstream_total());
+
+        [[maybe_unused]] const auto p4 = arena.allocate(10);
+        ASSERT_EQ(1U, upstream.count());
+    }
+    ASSERT_EQ(0U, upstream.count());
+    ASSERT_EQ(0U, upstream.allocated());
+}
+
+TEST_F(TestMonotonicArena, Pmr)
+{
+    counting_resource upstream;
+    monotonic_arena arena(&upstream);
+    std::pmr::vector<std::pmr::string> v(&arena);
+    for (int i = 0; i < 100; ++i) {
+        v.emplace_back("a string which is long enough not to be small");
+    }
+    ASSERT_EQ(&arena, v.get_allocator().resource());
+    ASSERT_EQ(&arena, v.back().get_allocator().resource());
+    ASSERT_LT(0U, upstream.count());
+}
+
+TEST_F(TestMonotonicArena, Allocator)
+{
+    monotonic_arena arena1;
+    monotonic_arena arena2;
+    monotonic_arena_allocator<int> a1(arena1);
+    monotonic_arena_allocator<double> a1d(a1);
+    monotonic_arena_allocator<int> a2(arena2);
+    ASSERT_EQ(a1, a1d);
+    ASSERT_NE(a1, a2);
+    ASSERT_EQ(&arena1, &a1d.arena());
+
+    std::vector<int, monotonic_arena_allocator<int>> v(a1);
+    v.assign(1000, 42);
+    ASSERT_EQ(42, v[999]);
+    ASSERT_LT(1000 * sizeof(int), arena1.upstream_total());
+    ASSERT_EQ(0U, arena2.upstream_total());
+}
+
+TEST_F(TestMonotonicArena, StoredTable)
+{
+    using content_t = std::deque<std::vector<stored_value>>;
+    using a_t = monotonic_arena_allocator<content_t>;
+
+    counting_resource upstream;
+    monotonic_arena arena(&upstream);
+    {
+        basic_stored_table<content_t, a_t> table(
+            std::allocator_arg, a_t(arena), 16U);
+        try {
+            parse_csv("col1,col2\n"
+                      "aaa,bbb\n"
+                      "ccc,ddd\n", make_stored_table_builder(table));
+        } catch (const text_error& e) {
+            FAIL() << text_error_info(e);
+        }
+        ASSERT_EQ(3U, table.size());
+        ASSERT_EQ("ddd", table[2][1]);
+        ASSERT_EQ(&arena, &table.get_allocator().arena());
+    }
+    // Destruction of the table does not return any memory to the upstream
+    ASSERT_LT(0U, upstream.count());
+    arena.release();
+    ASSERT_EQ(0U, upstream.count());
+}
+
+TEST_F(TestMonotonicArena, StoredTablePmr)
+{
+    using content_t = std::pmr::deque<std::pmr::vector<stored_value>>;
+    using a_t = std::pmr::polymorphic_allocator<content_t>;
+
+    monotonic_arena arena;
+    basic_stored_table<content_t, a_t> table(
+        std::allocator_arg, a_t(&arena), 16U);
+    try {
+        parse_csv("col1,col2\n"
+                  "aaa,bbb\n", make_stored_table_builder(table));
+    } catch (const text_error& e) {
+        FAIL() << text_error_info(e);
+    }
+    ASSERT_EQ(2U, table.size());
+    ASSERT_EQ("bbb", table[1][1]);
+    // The inner containers are also on the arena
+    ASSERT_EQ(&arena, table[1].get_allocator().resource());
+}
+
+TEST_F(TestMonotonicArena, TablePull)
+{
+    // table_pull requires its allocator to be default-constructible, so
+    // std::pmr::polymorphic_allocator is used to make it work on the arena
+    monotonic_arena arena;
+    std::pmr::polymorphic_allocator<char> a(&arena);
+    auto pull = make_table_pull(std::allocator_arg, a,
+        make_csv_source(std::string("col1,col2\nval1,val2\n")));
+    std::vector<std::string> values;
+    while (pull()) {
+        if (pull.state() == table_pull_state::field) {
+            values.emplace_back(*pull);
+        }
+    }
+    ASSERT_EQ(4U, values.size());
+    ASSERT_EQ("val2", values.back());
+    ASSERT_LT(0U, arena.upstream_total());
+}
+
+TEST_F(TestMonotonicArena, TableScanner)
+{
+    monotonic_arena arena;
+    monotonic_arena_allocator<char> a(arena);
+    basic_table_scanner<char, std::char_traits<char>,
+                        monotonic_arena_allocator<char>>
+        scanner(std::allocator_arg, a, 1U);
+    std::vector<int> values;
+    scanner.set_field_scanner(1, make_field_translator(values));
+    try {
+        parse_csv("a,b\n1,10\n2,20\n", std::move(scanner));
+    } catch (const text_error& e) {
+        FAIL() << text_error_info(e);
+    }
+    ASSERT_EQ((std::vector<int>{ 10, 20 }), values);
+    ASSERT_LT(0U, arena.upstream_total());
+}
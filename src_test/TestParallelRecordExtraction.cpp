@@ -0,0 +1,172 @@
+/**
+ * These codes are licensed under the Unlicense.
+ * http://unlicense.org
+ */
+
+#include <cstddef>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+#include <commata/parallel_record_extraction.hpp>
+#include <commata/parse_csv.hpp>
+#include <commata/parse_error.hpp>
+#include <commata/parse_tsv.hpp>
+#include <commata/record_extractor.hpp>
+
+#include "BaseTest.hpp"
+
+using namespace commata;
+using namespace commata::test;
+
+namespace {
+
+using Chs = testing::Types<char, wchar_t>;
+
+template <class Ch>
+std::basic_string<Ch> make_csv(std::size_t n)
+{
+    const auto str = char_helper<Ch>::str;
+    std::basic_string<Ch> s = str("id,\"k\",v\r\n");
+    for (std::size_t i = 0; i < n; ++i) {
+        s += char_helper<Ch>::to_string(i);
+        switch (i % 5) {
+        case 0:
+            s += str(",x,plain\n");
+            break;
+        case 1:
+            s += str(",\"x\",\"quoted\r\n\"\"line\"\"\n\"\r\n");
+            break;
+        case 2:
+            s += str(",y,\n\n");
+            break;
+        case 3:
+            s += str(",\"y\"\r\n");
+            break;
+        default:
+            s += str("\n");         // too short to have the target field
+            break;
+        }
+    }
+    return s;
+}
+
+}
+
+template <class Ch>
+struct TestParallelRecordExtraction : BaseTest
+{};
+
+TYPED_TEST_SUITE(TestParallelRecordExtraction, Chs);
+
+TYPED_TEST(TestParallelRecordExtraction, ByFieldName)
+{
+    using string_t = std::basic_string<TypeParam>;
+
+    const auto str = char_helper<TypeParam>::str;
+
+    const auto csv = make_csv<TypeParam>(200);
+    const auto key = str("k");
+    const auto value = str("x");
+
+    for (const auto header : { header_forwarding::yes,
+                               header_forwarding::no }) {
+        std::basic_stringbuf<TypeParam> expected;
+        parse_csv(csv, make_record_extractor(expected, key, value, header));
+        ASSERT_FALSE(expected.str().empty());
+
+        for (const std::size_t thread_count : { 1, 4 }) {
+            for (const std::size_t chunk_size : { 1, 7, 64, 0 }) {
+                std::basic_stringbuf<TypeParam> out;
+                extract_records_in_parallel(make_csv_source(csv), out,
+                    key, value, header, thread_count, chunk_size);
+                ASSERT_EQ(expected.str(), out.str())
+                    << thread_count << ' ' << chunk_size;
+            }
+        }
+    }
+
+    // Predicates of the field values
+    std::basic_stringstream<TypeParam> in;
+    in << csv;
+    std::basic_stringbuf<TypeParam> out;
+    extract_records_in_parallel(make_csv_source(in), out,
+        [](std::basic_string_view<TypeParam> name) {
+            return (name.size() == 1) && (name[0] == 'k');
+        },
+        [](std::basic_string_view<TypeParam> v) {
+            return (v.size() == 1) && (v[0] == 'y');
+        },
+        header_forwarding::no, 3, 16);
+    std::basic_stringbuf<TypeParam> expected;
+    parse_csv(csv, make_record_extractor(expected, key, str("y"),
+        header_forwarding::no));
+    ASSERT_EQ(expected.str(), out.str());
+    ASSERT_NE(string_t::npos, out.str().find(str(",\"y\"\n")));
+}
+
+TYPED_TEST(TestParallelRecordExtraction, ByFieldIndex)
+{
+    const auto str = char_helper<TypeParam>::str;
+
+    std::basic_string<TypeParam> tsv;
+    for (int i = 0; i < 100; ++i) {
+        tsv += str((i % 3 == 0) ? "a\t\"b\n" : "\"a\t\tb\r\n");
+    }
+
+    std::basic_stringbuf<TypeParam> expected;
+    parse_tsv(tsv, make_record_extractor(
+        expected, 1, str("\"b"), std::nullopt));
+    ASSERT_FALSE(expected.str().empty());
+
+    for (const std::size_t chunk_size : { 1, 10, 0 }) {
+        std::basic_stringbuf<TypeParam> out;
+        extract_records_in_parallel(make_tsv_source(tsv), out,
+            1, str("\"b"), std::nullopt, 4, chunk_size);
+        ASSERT_EQ(expected.str(), out.str()) << chunk_size;
+    }
+}
+
+TYPED_TEST(TestParallelRecordExtraction, Error)
+{
+    const auto str = char_helper<TypeParam>::str;
+
+    auto csv = make_csv<TypeParam>(100);
+    csv += str("100,x,\"ab\"c\n");
+    csv += make_csv<TypeParam>(10);
+
+    // The records before the error are written as the sequential
+    // extraction writes them
+    std::optional<std::pair<std::size_t, std::size_t>> expected;
+    std::basic_stringbuf<TypeParam> expected_out;
+    try {
+        parse_csv(csv, make_record_extractor(
+            expected_out, str("k"), str("x")));
+        FAIL();
+    } catch (const parse_error& e) {
+        expected = e.get_physical_position();
+    }
+    ASSERT_TRUE(expected.has_value());
+    ASSERT_FALSE(expected_out.str().empty());
+
+    for (const std::size_t chunk_size : { 1, 8, 64, 256, 0 }) {
+        std::basic_stringbuf<TypeParam> out;
+        try {
+            extract_records_in_parallel(make_csv_source(csv), out,
+                str("k"), str("x"), header_forwarding::yes, 4, chunk_size);
+            FAIL() << chunk_size;
+        } catch (const parse_error& e) {
+            ASSERT_EQ(expected, e.get_physical_position()) << chunk_size;
+        }
+        ASSERT_EQ(expected_out.str(), out.str()) << chunk_size;
+    }
+
+    std::basic_stringbuf<TypeParam> out;
+    ASSERT_THROW(extract_records_in_parallel(make_csv_source(csv), out,
+            str("K"), str("x")),
+        record_extraction_error);
+}
@@ -17,6 +17,7 @@
 #include <gtest/gtest.h>
 
 #include <commata/parse_csv.hpp>
+#include <commata/parse_error.hpp>
 #include <commata/record_extractor.hpp>
 
 #include "BaseTest.hpp"
@@ -289,6 +290,105 @@ TEST_F(TestRecordExtractorIndexed, ConstRValueRefString)
     ASSERT_EQ(L"star,alnilam\n", std::move(out).str());
 }
 
+struct TestRecordExtractorMulti : BaseTestWithParam<std::size_t>
+{};
+
+TEST_P(TestRecordExtractorMulti, All)
+{
+    const char* s = "key_a,key_b,value_a,value_b\n"
+                    "ka1,kb1,va1,vb1\n"
+                    "ka1,kb2,va2,vb2\n"
+                    R"("ka1",kb1,"v)" "\n"
+                    R"(a3",vb3)" "\r\n"
+                    "ka2,kb1,va4,vb4\n"
+                    "ka1\n";
+    std::stringbuf out;
+    parse_csv(s, make_multi_record_extractor(out, key_combination::all,
+        std::make_tuple(std::make_pair("key_b", "kb1"),
+                        std::make_pair("key_a", "ka1"))), GetParam());
+    ASSERT_EQ("key_a,key_b,value_a,value_b\n"
+              "ka1,kb1,va1,vb1\n"
+              "\"ka1\",kb1,\"v\na3\",vb3\n",
+              std::move(out).str());
+}
+
+TEST_P(TestRecordExtractorMulti, Any)
+{
+    const wchar_t* s = L"key_a,key_b,value_a,value_b\n"
+                       L"ka1,kb1,va1,vb1\n"
+                       L"ka2,kb2,va2,vb2\n"
+                       L"ka3,kb3,\"v\na3\",vb3\n"
+                       L"ka4\n";
+    std::wstringbuf out;
+    parse_csv(s, make_multi_record_extractor(out, key_combination::any,
+        std::make_tuple(
+            std::make_pair(L"key_a"s, L"ka1"),
+            std::make_pair(L"value_a",
+                [](std::wstring_view v) { return v.size() > 3; })),
+        header_forwarding::no), GetParam());
+    ASSERT_EQ(L"ka1,kb1,va1,vb1\n"
+              L"ka3,kb3,\"v\na3\",vb3\n",
+              std::move(out).str());
+}
+
+TEST_P(TestRecordExtractorMulti, SameField)
+{
+    const char* s = "key_a,key_b\n"
+                    "ka1,kb1\n"
+                    "ka12,kb2\n"
+                    "ka2,kb3\n";
+    std::stringbuf out;
+    parse_csv(s, make_multi_record_extractor(out, key_combination::all,
+        std::make_tuple(
+            std::make_pair("key_a",
+                [](std::string_view v) { return v.substr(0, 3) == "ka1"; }),
+            std::make_pair("key_a",
+                [](std::string_view v) { return v.size() > 3; })),
+        header_forwarding::no), GetParam());
+    ASSERT_EQ("ka12,kb2\n", std::move(out).str());
+}
+
+TEST_P(TestRecordExtractorMulti, DecidedEarly)
+{
+    const char* s = "key_a,key_b,key_c\n"
+                    "ka1,kb1,kc1\n"
+                    "ka2,kb2,kc2\n";
+    std::size_t count = 0;
+    const auto counted = [&count](std::string_view) {
+        ++count;
+        return true;
+    };
+    std::stringbuf out;
+    parse_csv(s, make_multi_record_extractor(out, key_combination::all,
+        std::make_tuple(std::make_pair("key_a", "ka2"),
+                        std::make_pair("key_c", counted))), GetParam());
+    ASSERT_EQ(1U, count);
+    ASSERT_EQ("key_a,key_b,key_c\n"
+              "ka2,kb2,kc2\n",
+              std::move(out).str());
+}
+
+TEST_P(TestRecordExtractorMulti, NoSuchKey)
+{
+    const char* s = "key_a,key_b\n"
+                    "ka1,kb1\n";
+    std::stringbuf out;
+    try {
+        parse_csv(s, make_multi_record_extractor(out, key_combination::any,
+            std::make_tuple(std::make_pair("key_a", "ka1"),
+                            std::make_pair("key_c", "kc1"))), GetParam());
+        FAIL();
+    } catch (const record_extraction_error& e) {
+        ASSERT_TRUE(e.get_physical_position());
+        ASSERT_EQ(0U, e.get_physical_position()->first);
+        std::string message(e.what());
+        ASSERT_NE(std::string::npos, message.find("key_c")) << message;
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(, TestRecordExtractorMulti,
+    testing::Values(1, 10, 1024));
+
 namespace {
 
 struct final_predicate_for_value final
@@ -641,3 +741,70 @@ TEST_F(TestRecordExtractorMiscellaneous, EvadeCopyingIndexed)
                  "clarinet,woodwind\n", std::move(out).str().c_str());
     ASSERT_EQ(0U, total);
 }
+
+namespace {
+
+// Counts the calls of xsputn and overflow
+class counting_stringbuf : public std::stringbuf
+{
+public:
+    std::size_t put_count = 0;
+
+protected:
+    std::streamsize xsputn(const char* s, std::streamsize n) override
+    {
+        ++put_count;
+        return std::stringbuf::xsputn(s, n);
+    }
+
+    int_type overflow(int_type c) override
+    {
+        ++put_count;
+        return std::stringbuf::overflow(c);
+    }
+};
+
+} // end unnamed
+
+TEST_F(TestRecordExtractorMiscellaneous, AdjacentRecordsInOneGo)
+{
+    const char* s = "instrument,type\n"
+                    "castanets,idiophone\n"
+                    "\"tri\nangle\",idiophone\n"
+                    "clarinet,woodwind\n"
+                    "xylophone,idiophone\r\n"
+                    "marimba,idiophone";
+    const char* expected = "instrument,type\n"
+                           "castanets,idiophone\n"
+                           "\"tri\nangle\",idiophone\n"
+                           "xylophone,idiophone\n"
+                           "marimba,idiophone\n";
+
+    {
+        counting_stringbuf out;
+        parse_csv(s, make_record_extractor(out, "type", "idiophone"));
+        ASSERT_EQ(expected, std::move(out).str());
+        ASSERT_EQ(5U, out.put_count);   // the header and 2 records in one
+                                        // go, and 1 record and 1 LF twice
+    }
+    for (const std::size_t buffer_size : { 1, 2, 7 }) {
+        counting_stringbuf out;
+        parse_csv(s, make_record_extractor(out, "type", "idiophone"),
+            buffer_size);
+        ASSERT_EQ(expected, std::move(out).str()) << buffer_size;
+    }
+}
+
+TEST_F(TestRecordExtractorMiscellaneous, AdjacentRecordsBeforeError)
+{
+    const char* s = "instrument,type\n"
+                    "castanets,idiophone\n"
+                    "triangle,idiophone\n"
+                    "clari\"net,woodwind\n";
+    std::stringbuf out;
+    ASSERT_THROW(parse_csv(s, make_record_extractor(out, 1, "idiophone")),
+        parse_error);
+    ASSERT_EQ("instrument,type\n"
+              "castanets,idiophone\n"
+              "triangle,idiophone\n", std::move(out).str());
+}
@@ -0,0 +1,151 @@
+/**
+ * These codes are licensed under the Unlicense.
+ * http://unlicense.org
+ */
+
+#include <commata/record_generator.hpp>
+
+#ifdef __cpp_lib_coroutine
+
+#include <cstddef>
+#include <memory>
+#include <ranges>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <commata/parse_csv.hpp>
+#include <commata/parse_error.hpp>
+#include <commata/parse_tsv.hpp>
+
+#include "BaseTest.hpp"
+#include "tracking_allocator.hpp"
+
+using namespace commata;
+using namespace commata::test;
+
+namespace {
+
+using ChBs = testing::Types<
+    std::pair<char, std::integral_constant<std::size_t, 1>>,
+    std::pair<char, std::integral_constant<std::size_t, 3>>,
+    std::pair<char, std::integral_constant<std::size_t, 1024>>,
+    std::pair<wchar_t, std::integral_constant<std::size_t, 1>>,
+    std::pair<wchar_t, std::integral_constant<std::size_t, 1024>>>;
+
+}
+
+template <class ChB>
+struct TestRecordGenerator : BaseTest
+{};
+
+TYPED_TEST_SUITE(TestRecordGenerator, ChBs);
+
+TYPED_TEST(TestRecordGenerator, Basics)
+{
+    using char_t = typename TypeParam::first_type;
+    using string_t = std::basic_string<char_t>;
+
+    const auto str = char_helper<char_t>::str;
+
+    const auto csv = str("ab,\"c\"\"d\",e\n"
+                         "\n"
+                         "\"f\r\ng\",\r\n"
+                         "hij");
+    for (const bool indirect_source : { false, true }) {
+        std::vector<std::vector<string_t>> records_read;
+        auto g = indirect_source ?
+            records(make_csv_source(indirect, csv),
+                    TypeParam::second_type::value) :
+            records(make_csv_source(csv), TypeParam::second_type::value);
+        for (const auto& r : g) {
+            records_read.emplace_back(r.begin(), r.end());
+        }
+        ASSERT_EQ((std::vector<std::vector<string_t>>{
+                    { str("ab"), str("c\"d"), str("e") },
+                    { str("f\r\ng"), string_t() },
+                    { str("hij") } }),
+                  records_read);
+    }
+}
+
+TYPED_TEST(TestRecordGenerator, Ranges)
+{
+    using char_t = typename TypeParam::first_type;
+
+    const auto str = char_helper<char_t>::str;
+
+    std::basic_stringstream<char_t> s;
+    s << str("a\tb\tc\nd\ne\tf\n");
+    auto sizes = records(make_tsv_source(s), TypeParam::second_type::value)
+               | std::views::transform([](const auto& r) { return r.size(); });
+    std::vector<std::size_t> v;
+    for (const auto n : sizes) {
+        v.push_back(n);
+    }
+    ASSERT_EQ((std::vector<std::size_t>{ 3, 1, 2 }), v);
+}
+
+TYPED_TEST(TestRecordGenerator, NoFinalLineFeed)
+{
+    using char_t = typename TypeParam::first_type;
+    using string_t = std::basic_string<char_t>;
+
+    for (std::size_t n = 1; n < 12; ++n) {
+        for (std::size_t m = 0; m < 12; ++m) {
+            const string_t a(n, char_t('a'));
+            const string_t d(m, char_t('d'));
+            std::basic_istringstream<char_t> in(a + char_t(',') + d);
+            std::vector<std::vector<string_t>> records_read;
+            for (const auto& r : records(make_csv_source(in),
+                                         TypeParam::second_type::value)) {
+                records_read.emplace_back(r.begin(), r.end());
+            }
+            ASSERT_EQ((std::vector<std::vector<string_t>>{ { a, d } }),
+                      records_read) << n << ' ' << m;
+        }
+    }
+}
+
+TYPED_TEST(TestRecordGenerator, Error)
+{
+    using char_t = typename TypeParam::first_type;
+
+    const auto str = char_helper<char_t>::str;
+
+    auto g = records(make_csv_source(str("a,b\nc\"d\ne")),
+                     TypeParam::second_type::value);
+    auto i = g.begin();
+    ASSERT_NE(std::default_sentinel, i);
+    ASSERT_EQ(2U, i->size());
+    ASSERT_THROW(++i, parse_error);
+    ASSERT_EQ(std::default_sentinel, i);
+}
+
+TYPED_TEST(TestRecordGenerator, Allocator)
+{
+    using char_t = typename TypeParam::first_type;
+    using alloc_t = tracking_allocator<std::allocator<char_t>>;
+
+    const auto str = char_helper<char_t>::str;
+
+    std::vector<std::pair<char*, char*>> allocated;
+    std::size_t total = 0U;
+    alloc_t a(allocated, total);
+    {
+        std::size_t n = 0;
+        for (const auto& r : records(std::allocator_arg, a,
+                make_csv_source(indirect, str("\"a\nb\",c\nd,e\n")),
+                TypeParam::second_type::value)) {
+            n += r.size();
+            ASSERT_GT(total, 0U);
+        }
+        ASSERT_EQ(4U, n);
+    }
+    ASSERT_TRUE(allocated.empty());
+}
+
+#endif
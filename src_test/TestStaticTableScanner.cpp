@@ -0,0 +1,168 @@
+/**
+ * These codes are licensed under the Unlicense.
+ * http://unlicense.org
+ */
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <commata/field_scanners.hpp>
+#include <commata/parse_csv.hpp>
+#include <commata/static_table_scanner.hpp>
+#include <commata/text_error.hpp>
+
+#include "BaseTest.hpp"
+#include "tracking_allocator.hpp"
+
+using namespace commata;
+using namespace commata::test;
+
+namespace {
+
+using Chs = testing::Types<char, wchar_t>;
+
+template <class Ch>
+struct const_only_scanner
+{
+    std::vector<std::basic_string<Ch>>* values;
+
+    void operator()(const Ch* begin, const Ch* end)
+    {
+        values->emplace_back(begin, end);
+    }
+
+    void operator()()
+    {
+        values->emplace_back();
+    }
+};
+
+} // end unnamed
+
+template <class Ch>
+struct TestStaticTableScanner : BaseTest
+{};
+
+TYPED_TEST_SUITE(TestStaticTableScanner, Chs);
+
+TYPED_TEST(TestStaticTableScanner, Basics)
+{
+    using string_t = std::basic_string<TypeParam>;
+
+    const auto str = char_helper<TypeParam>::str;
+
+    std::deque<long> values0;
+    std::vector<string_t> values2;
+    std::vector<double> values3;
+
+    auto h = make_static_table_scanner<TypeParam>(1U,
+        make_field_translator(values0),
+        nullptr,
+        make_field_translator(values2),
+        make_field_translator(values3, replace_if_skipped(-1.0)));
+    static_assert(std::is_same_v<const TypeParam,
+                                 typename decltype(h)::char_type>);
+    ASSERT_TRUE(h.is_in_header());
+
+    std::basic_stringstream<TypeParam> s;
+    s << "F0,F1,F2,F3,F4\r"
+         "50,__,XYZ, 101.2 ,ignored\n"
+         R"(-3,__,"""ab"")" "\r"
+         R"(c",3.00e9)" "\n"
+         "7,__,end";
+    for (const std::size_t buffer_size : { 2U, 7U, 1024U }) {
+        values0.clear();
+        values2.clear();
+        values3.clear();
+        s.clear();
+        s.seekg(0);
+        auto h2 = make_static_table_scanner<TypeParam>(1U,
+            make_field_translator(values0),
+            nullptr,
+            make_field_translator(values2),
+            make_field_translator(values3, replace_if_skipped(-1.0)));
+        try {
+            parse_csv(s, std::move(h2), buffer_size);
+        } catch (const text_error& e) {
+            FAIL() << text_error_info(e);
+        }
+
+        ASSERT_EQ((std::deque<long>{ 50, -3, 7 }), values0) << buffer_size;
+        ASSERT_EQ((std::vector<string_t>{
+                    str("XYZ"), str("\"ab\"\rc"), str("end") }), values2)
+            << buffer_size;
+        ASSERT_EQ((std::vector<double>{ 101.2, 3.00e9, -1.0 }), values3)
+            << buffer_size;
+    }
+}
+
+TYPED_TEST(TestStaticTableScanner, Direct)
+{
+    using string_t = std::basic_string<TypeParam>;
+
+    const auto str = char_helper<TypeParam>::str;
+
+    std::vector<int> values0;
+    std::vector<string_t> values1;
+    auto t = make_field_translator(values0);
+    auto h = make_static_table_scanner<TypeParam>(0U,
+        std::ref(t), const_only_scanner<TypeParam>{ &values1 });
+
+    const auto s = str("1,\"a\"\"b\"\n23,cd\n456");
+    try {
+        parse_csv(s /*direct*/, std::move(h));
+    } catch (const text_error& e) {
+        FAIL() << text_error_info(e);
+    }
+    ASSERT_EQ((std::vector<int>{ 1, 23, 456 }), values0);
+    ASSERT_EQ((std::vector<string_t>{ str("a\"b"), str("cd"), string_t() }),
+              values1);
+    ASSERT_EQ(str("1,\"a\"\"b\"\n23,cd\n456"), s);
+}
+
+TYPED_TEST(TestStaticTableScanner, FieldScannerAccess)
+{
+    std::vector<int> values;
+    const auto h = make_static_table_scanner<TypeParam>(0U,
+        nullptr, make_field_translator(values));
+    ASSERT_EQ(nullptr, h.template get_field_scanner<0>());
+    ASSERT_EQ(typeid(make_field_translator(values)),
+              typeid(h.template get_field_scanner<1>()));
+    ASSERT_FALSE(h.is_in_header());
+}
+
+TYPED_TEST(TestStaticTableScanner, Allocator)
+{
+    using string_t = std::basic_string<TypeParam>;
+    using alloc_t = tracking_allocator<std::allocator<TypeParam>>;
+
+    const auto str = char_helper<TypeParam>::str;
+
+    std::vector<std::pair<char*, char*>> allocated;
+    std::size_t total = 0U;
+    alloc_t a(allocated, total);
+
+    std::vector<string_t> values;
+    auto h = make_static_table_scanner<TypeParam, std::char_traits<TypeParam>>(
+        std::allocator_arg, a, 0U, make_field_translator(values));
+    ASSERT_EQ(a, h.get_allocator());
+
+    std::basic_stringstream<TypeParam> s;
+    s << str("abcdefghijklmnopqrstuvwxyz0123456789\n");
+    try {
+        parse_csv(s, std::move(h), 4U);
+    } catch (const text_error& e) {
+        FAIL() << text_error_info(e);
+    }
+    ASSERT_EQ(str("abcdefghijklmnopqrstuvwxyz0123456789"), values.at(0));
+    // The value is made up in the scanner's buffer with the allocator
+    ASSERT_GT(total, 0U);
+}
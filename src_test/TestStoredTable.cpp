@@ -1690,6 +1690,199 @@ TEST_F(TestStoredTableReusingBuffer, DoubleClear)
     table->consume_buffer(p.first, p.second);
 }
 
+struct TestStoredTableCompaction : BaseTest
+{};
+
+TEST_F(TestStoredTableCompaction, Compact)
+{
+    stored_table table(8U);
+    parse_csv("ab,cde\nfgh,i\n", make_stored_table_builder(table));
+    ASSERT_EQ(2U, table.size());
+
+    table.rewrite_value(table[0][0], "jklmnop");    // "ab" left dead
+    table.rewrite_value(table[1][1], "qrstuvwxyz"); // "i" left dead
+    table.content().emplace_back();
+    table.content().back().push_back(table.import_value("0123456789"));
+    table.content().back().push_back(stored_value());
+    table.resize_value(table[2][0], 0);
+
+    const auto reclaimed = table.compact();
+    ASSERT_GT(reclaimed, 0U);
+
+    ASSERT_EQ("jklmnop", table[0][0]);
+    ASSERT_EQ("cde", table[0][1]);
+    ASSERT_EQ("fgh", table[1][0]);
+    ASSERT_EQ("qrstuvwxyz", table[1][1]);
+    ASSERT_TRUE(table[2][0].empty());
+    ASSERT_TRUE(table[2][1].empty());
+
+    // Values are laid out contiguously in record order
+    ASSERT_EQ(table[0][0].cend() + 1, table[0][1].cbegin());
+    ASSERT_EQ(table[0][1].cend() + 1, table[1][0].cbegin());
+    ASSERT_EQ(table[1][0].cend() + 1, table[1][1].cbegin());
+
+    // Nothing to reclaim any longer
+    ASSERT_EQ(0U, table.compact());
+
+    // The table is still writable after compaction
+    table.rewrite_value(table[2][1], "XYZ");
+    ASSERT_EQ("XYZ", table[2][1]);
+    ASSERT_EQ("jklmnop", table[0][0]);
+}
+
+TEST_F(TestStoredTableCompaction, CompactConst)
+{
+    cstored_table table;
+    parse_csv("Asterids,Saussurea\nAsterids,Cirsium\nAsterids,Saussurea\n",
+        make_stored_table_builder(table));
+    table.rewrite_value(table[1][1], "Serratula");
+
+    table.compact();
+
+    ASSERT_EQ("Asterids", table[0][0]);
+    ASSERT_EQ("Serratula", table[1][1]);
+    ASSERT_EQ("Saussurea", table[2][1]);
+    ASSERT_EQ(table[0][0].cbegin(), table[1][0].cbegin());
+    ASSERT_EQ(table[0][0].cbegin(), table[2][0].cbegin());
+    ASSERT_EQ(table[0][1].cbegin(), table[2][1].cbegin());
+
+    // Shared values are laid out in the order they first appear
+    ASSERT_EQ(table[0][0].cend() + 1, table[0][1].cbegin());
+    ASSERT_EQ(table[0][1].cend() + 1, table[1][1].cbegin());
+}
+
+TEST_F(TestStoredTableCompaction, Compactor)
+{
+    wstored_table table(16U);
+    parse_csv(L"ab,cd,ef\ngh,ij,kl\nmn,op,qr\n",
+        make_stored_table_builder(table));
+    for (auto& r : table.content()) {
+        for (auto& v : r) {
+            table.rewrite_value(v, std::wstring(20, v[0]));
+        }
+    }
+
+    auto compactor = make_stored_table_compactor(table);
+    ASSERT_FALSE(compactor.done());
+    ASSERT_FALSE(compactor(4));
+    ASSERT_EQ(std::wstring(20, L'a'), table[0][0]);
+    ASSERT_EQ(std::wstring(20, L'g'), table[1][0]);
+    ASSERT_EQ(std::wstring(20, L'm'), table[2][0]);
+
+    // Values rewritten during compaction are not copied again
+    table.rewrite_value(table[2][2], std::wstring(30, L's'));
+    const auto p = table[2][2].cbegin();
+
+    ASSERT_FALSE(compactor(4));
+    ASSERT_EQ(0U, compactor.reclaimed());
+    ASSERT_TRUE(compactor(4));
+    ASSERT_TRUE(compactor.done());
+    ASSERT_GT(compactor.reclaimed(), 0U);
+    ASSERT_TRUE(compactor());
+
+    ASSERT_EQ(std::wstring(20, L'a'), table[0][0]);
+    ASSERT_EQ(std::wstring(20, L'k'), table[1][2]);
+    ASSERT_EQ(std::wstring(20, L'o'), table[2][1]);
+    ASSERT_EQ(std::wstring(30, L's'), table[2][2]);
+    ASSERT_EQ(p, table[2][2].cbegin());
+}
+
+TEST_F(TestStoredTableCompaction, CompactorAbandoned)
+{
+    stored_table table(8U);
+    parse_csv("ab,cd\nef,gh\n", make_stored_table_builder(table));
+    table.rewrite_value(table[0][0], "ijklmnopq");
+
+    {
+        auto compactor = make_stored_table_compactor(table);
+        ASSERT_FALSE(compactor(1));
+    }
+
+    // Values not migrated shall still be backed by table
+    ASSERT_EQ("ijklmnopq", table[0][0]);
+    ASSERT_EQ("cd", table[0][1]);
+    ASSERT_EQ("gh", table[1][1]);
+    table.shrink_to_fit();
+    ASSERT_EQ("ef", table[1][0]);
+}
+
+TEST_F(TestStoredTableCompaction, CompactorAbandonedOnEmptyStore)
+{
+    stored_table table(8U);
+    table.content().emplace_back();
+    table.content().back().resize(3);
+
+    {
+        // The table has no buffers to retire
+        auto compactor = make_stored_table_compactor(table);
+        table.rewrite_value(table[0][0], "abcdef");
+        ASSERT_FALSE(compactor(0));
+    }
+
+    // The buffer added during the compaction shall stay well-linked
+    table.rewrite_value(table[0][1], "ghijklmnopq");
+    table.rewrite_value(table[0][2], "rstuvwxyz01");
+    ASSERT_EQ("abcdef", table[0][0]);
+    ASSERT_EQ("ghijklmnopq", table[0][1]);
+    ASSERT_EQ("rstuvwxyz01", table[0][2]);
+}
+
+struct TestStoredTableMemoryUsage : BaseTest
+{};
+
+TEST_F(TestStoredTableMemoryUsage, Basics)
+{
+    wstored_table table(20U);
+    {
+        const auto u = table.memory_usage();
+        ASSERT_EQ(0U, u.allocated);
+        ASSERT_EQ(0U, u.secured);
+        ASSERT_EQ(0U, u.cleared);
+        ASSERT_EQ(0U, u.buffer_count);
+        ASSERT_EQ(0U, u.content);
+    }
+
+    table.content().emplace_back();
+    table.content().back().push_back(table.import_value(L"abc"));
+    table.content().back().push_back(table.import_value(L"defgh"));
+    {
+        const auto u = table.memory_usage();
+        ASSERT_EQ(20U * sizeof(wchar_t), u.allocated);
+        ASSERT_EQ(10U * sizeof(wchar_t), u.secured);
+        ASSERT_EQ(0U, u.cleared);
+        ASSERT_EQ(1U, u.buffer_count);
+        ASSERT_GE(u.content, sizeof(wstored_table::content_type)
+                           + sizeof(wstored_table::record_type)
+                           + 2 * sizeof(wstored_value));
+    }
+
+    table.content().back().push_back(
+        table.import_value(std::wstring(30, L'x')));
+    {
+        const auto u = table.memory_usage();
+        ASSERT_EQ(51U * sizeof(wchar_t), u.allocated);
+        ASSERT_EQ(41U * sizeof(wchar_t), u.secured);
+        ASSERT_EQ(2U, u.buffer_count);
+    }
+
+    table.clear();
+    {
+        const auto u = table.memory_usage();
+        ASSERT_EQ(51U * sizeof(wchar_t), u.allocated);
+        ASSERT_EQ(0U, u.secured);
+        ASSERT_EQ(51U * sizeof(wchar_t), u.cleared);
+        ASSERT_EQ(2U, u.buffer_count);
+        ASSERT_EQ(0U, u.content);
+    }
+
+    table.compact();
+    {
+        const auto u = table.memory_usage();
+        ASSERT_EQ(0U, u.allocated);
+        ASSERT_EQ(0U, u.buffer_count);
+    }
+}
+
 struct TestStoredTableBuilder : BaseTestWithParam<std::size_t>
 {};
 
@@ -1912,6 +2105,226 @@ TEST_P(TestStoredTableBuilder, Transpose)
     ASSERT_EQ(3U, table[2].size());
 }
 
+TEST_P(TestStoredTableBuilder, ProjectionByIndex)
+{
+    const char* s = "id,name,price,qty\n"
+                    "1,\"apple, red\",120,5\n"
+                    "2,banana,80,12\n";
+    stored_table table(GetParam());
+    try {
+        parse_csv(s, make_stored_table_builder(table,
+            stored_table_projection{ 0, 2 }));
+    } catch (const text_error& e) {
+        FAIL() << text_error_info(e);
+    }
+
+    ASSERT_EQ(3U, table.size());
+    ASSERT_EQ(2U, table[0].size());
+    ASSERT_EQ("id", table[0][0]);
+    ASSERT_EQ("price", table[0][1]);
+    ASSERT_EQ(2U, table[1].size());
+    ASSERT_EQ("1", table[1][0]);
+    ASSERT_EQ("120", table[1][1]);
+    ASSERT_EQ(2U, table[2].size());
+    ASSERT_EQ("2", table[2][0]);
+    ASSERT_EQ("80", table[2][1]);
+}
+
+TEST_P(TestStoredTableBuilder, ProjectionByName)
+{
+    const wchar_t* s = L"id,name,price,qty\n"
+                       L"1,\"apple, red\",120,5\n"
+                       L"2,banana,80,12\n"
+                       L"3,cherry,450,1\n";
+    wstored_table table(GetParam());
+    wstored_table_projection projection;
+    projection.select(L"qty").select(L"name");
+    try {
+        parse_csv(s, make_stored_table_builder(table, projection, 3));
+    } catch (const text_error& e) {
+        FAIL() << text_error_info(e);
+    }
+
+    // Fields are stored in their original order
+    ASSERT_EQ(3U, table.size());
+    ASSERT_EQ(2U, table[0].size());
+    ASSERT_EQ(L"name", table[0][0]);
+    ASSERT_EQ(L"qty", table[0][1]);
+    ASSERT_EQ(2U, table[1].size());
+    ASSERT_EQ(L"apple, red", table[1][0]);
+    ASSERT_EQ(L"5", table[1][1]);
+    ASSERT_EQ(2U, table[2].size());
+    ASSERT_EQ(L"banana", table[2][0]);
+    ASSERT_EQ(L"12", table[2][1]);
+}
+
+TEST_P(TestStoredTableBuilder, ProjectionByNameMissing)
+{
+    const char* s = "id,name,price\n"
+                    "1,apple,120\n";
+    stored_table table(GetParam());
+    try {
+        parse_csv(s, make_stored_table_builder(table,
+            stored_table_projection{ "price", "qty" }));
+        FAIL();
+    } catch (const stored_table_projection_error& e) {
+        ASSERT_NE(std::string_view(e.what()).find("qty"),
+                  std::string_view::npos) << e.what();
+        const auto pos = e.get_physical_position();
+        ASSERT_TRUE(pos.has_value());
+        ASSERT_EQ(0U, pos->first);
+    }
+}
+
+TEST_P(TestStoredTableBuilder, ProjectionTransposed)
+{
+    const char* s = "Col1,Col2,Col3\n"
+                    "aaa,bbb,ccc\n"
+                    "AAA,BBB,CCC\n";
+    stored_table table(GetParam());
+    std::size_t n = 0;
+    try {
+        parse_csv(s, make_stored_table_builder<
+            stored_table_builder_option::transpose>(table,
+                stored_table_projection{ "Col3" }.select(0),
+                [&n] { ++n; }));
+    } catch (const text_error& e) {
+        FAIL() << text_error_info(e);
+    }
+
+    ASSERT_EQ(3U, n);
+    ASSERT_EQ(2U, table.size());
+    ASSERT_EQ(3U, table[0].size());
+    ASSERT_EQ("Col1", table[0][0]);
+    ASSERT_EQ("aaa", table[0][1]);
+    ASSERT_EQ("AAA", table[0][2]);
+    ASSERT_EQ(3U, table[1].size());
+    ASSERT_EQ("Col3", table[1][0]);
+    ASSERT_EQ("ccc", table[1][1]);
+    ASSERT_EQ("CCC", table[1][2]);
+}
+
+TEST_P(TestStoredTableBuilder, FilterRecords)
+{
+    const char* s = "id,price,name\n"
+                    "1,120,\"apple, red\"\n"
+                    "2,80,banana\n"
+                    "3,450,cherry\n"
+                    "4,,durian\n";
+    stored_table table(GetParam());
+    std::vector<std::size_t> indices;
+    try {
+        parse_csv(s, make_stored_table_builder(table).filter_records(
+            [&indices](std::size_t j, std::string_view v) {
+                indices.push_back(j);
+                return (j != 1) || (v == "price")
+                    || ((v.size() == 3) && (v >= "100"));
+            }));
+    } catch (const text_error& e) {
+        FAIL() << text_error_info(e);
+    }
+
+    ASSERT_EQ(3U, table.size());
+    ASSERT_EQ(3U, table[0].size());
+    ASSERT_EQ("price", table[0][1]);
+    ASSERT_EQ(3U, table[1].size());
+    ASSERT_EQ("1", table[1][0]);
+    ASSERT_EQ("120", table[1][1]);
+    ASSERT_EQ("apple, red", table[1][2]);
+    ASSERT_EQ(3U, table[2].size());
+    ASSERT_EQ("3", table[2][0]);
+    ASSERT_EQ("450", table[2][1]);
+    ASSERT_EQ("cherry", table[2][2]);
+
+    // Fields after the rejecting one are not seen by the filter
+    ASSERT_EQ(13U, indices.size());
+}
+
+TEST_P(TestStoredTableBuilder, FilterRecordsProjected)
+{
+    const wchar_t* s = L"id,name,price,qty\n"
+                       L"1,\"apple, red\",120,5\n"
+                       L"2,banana,80,12\n"
+                       L"3,cherry,450,0\n"
+                       L"4,durian,1200,3\n"
+                       L"5,elderberry,60,7\n";
+    wstored_table table(GetParam());
+    try {
+        // The filter sees fields not projected, and the records it rejects
+        // are not counted for max_record_num
+        auto builder = make_stored_table_builder(
+            table, wstored_table_projection{ L"name", L"price" }, 3);
+        builder.filter_records([](std::size_t j, std::wstring_view v) {
+            return (j != 3) || (v != L"0");
+        });
+        parse_csv(s, std::move(builder));
+    } catch (const text_error& e) {
+        FAIL() << text_error_info(e);
+    }
+
+    ASSERT_EQ(3U, table.size());
+    ASSERT_EQ(2U, table[0].size());
+    ASSERT_EQ(L"name", table[0][0]);
+    ASSERT_EQ(L"price", table[0][1]);
+    ASSERT_EQ(2U, table[1].size());
+    ASSERT_EQ(L"apple, red", table[1][0]);
+    ASSERT_EQ(L"120", table[1][1]);
+    ASSERT_EQ(2U, table[2].size());
+    ASSERT_EQ(L"banana", table[2][0]);
+    ASSERT_EQ(L"80", table[2][1]);
+}
+
+TEST_P(TestStoredTableBuilder, FilterRecordsTransposed)
+{
+    const char* s = "Col1,Col2\n"
+                    "aaa,bbb\n"
+                    "xxx,yyy\n"
+                    "AAA,BBB\n";
+    stored_table table(GetParam());
+    try {
+        parse_csv(s, make_stored_table_builder<
+            stored_table_builder_option::transpose>(table).filter_records(
+                [](std::size_t, std::string_view v) {
+                    return v.front() != 'x';
+                }));
+    } catch (const text_error& e) {
+        FAIL() << text_error_info(e);
+    }
+
+    ASSERT_EQ(2U, table.size());
+    ASSERT_EQ(3U, table[0].size());
+    ASSERT_EQ("Col1", table[0][0]);
+    ASSERT_EQ("aaa", table[0][1]);
+    ASSERT_EQ("AAA", table[0][2]);
+    ASSERT_EQ(3U, table[1].size());
+    ASSERT_EQ("Col2", table[1][0]);
+    ASSERT_EQ("bbb", table[1][1]);
+    ASSERT_EQ("BBB", table[1][2]);
+}
+
+TEST_P(TestStoredTableBuilder, ProjectionMemoryUsage)
+{
+    std::string s = "id,name,price,qty\n";
+    for (int i = 0; i < 100; ++i) {
+        s += "1,this is a long description to be dropped,120,5\n";
+    }
+    stored_table full(GetParam());
+    stored_table projected(GetParam());
+    try {
+        parse_csv(s, make_stored_table_builder(full));
+        parse_csv(s, make_stored_table_builder(projected,
+            stored_table_projection{ 0, 2, 3 }));
+    } catch (const text_error& e) {
+        FAIL() << text_error_info(e);
+    }
+
+    ASSERT_EQ(101U, projected.size());
+    ASSERT_EQ("120", projected[100][1]);
+    // Values not projected do not occupy the store
+    ASSERT_LT(projected.memory_usage().secured * 3,
+              full.memory_usage().secured);
+}
+
 TEST_P(TestStoredTableBuilder, Fancy)
 {
     using content_t = std::vector<std::vector<wstored_value>>;
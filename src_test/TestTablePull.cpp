@@ -23,6 +23,50 @@ using namespace commata::test;
 
 namespace {
 
+template <class T>
+struct counting_allocator : std::allocator<T>
+{
+    std::size_t* count;
+
+    template <class U>
+    struct rebind
+    {
+        using other = counting_allocator<U>;
+    };
+
+    // Required for the queue of moved-from objects, which never allocates
+    counting_allocator() noexcept :
+        count(nullptr)
+    {}
+
+    explicit counting_allocator(std::size_t& c) noexcept :
+        count(&c)
+    {}
+
+    template <class U>
+    counting_allocator(const counting_allocator<U>& other) noexcept :
+        count(other.count)
+    {}
+
+    T* allocate(std::size_t n)
+    {
+        ++*count;
+        return std::allocator<T>::allocate(n);
+    }
+
+    friend bool operator==(const counting_allocator& left,
+        const counting_allocator& right) noexcept
+    {
+        return left.count == right.count;
+    }
+
+    friend bool operator!=(const counting_allocator& left,
+        const counting_allocator& right) noexcept
+    {
+        return !(left == right);
+    }
+};
+
 template <class PrimitiveTablePull>
 auto transcript_primitive(PrimitiveTablePull&& pull,
     bool at_start_buffer = false, bool at_end_buffer = false)
@@ -189,6 +233,33 @@ TYPED_TEST_P(TestTablePull, PrimitiveMove)
     ASSERT_EQ(str("C+D"), s);
 }
 
+TYPED_TEST_P(TestTablePull, PrimitiveNoQueueAllocation)
+{
+    using char_t = typename TypeParam::first_type;
+    using alloc_t = counting_allocator<char_t>;
+
+    const auto str = char_helper<char_t>::str;
+
+    std::basic_string<char_t> csv;
+    for (std::size_t i = 0; i < 100; ++i) {
+        csv += str("a,,\"b\"\"c\",d\r\n\n");
+    }
+
+    std::size_t count = 0U;
+    primitive_table_pull pull(std::allocator_arg, alloc_t(count),
+        make_csv_source(csv), TypeParam::second_type::value);
+    const auto count_on_construction = count;
+
+    std::size_t n = 0;
+    while (pull()) {
+        if (pull.state() == primitive_table_pull_state::finalize) {
+            ++n;
+        }
+    }
+    ASSERT_EQ(400U, n);
+    ASSERT_EQ(count_on_construction, count);
+}
+
 TYPED_TEST_P(TestTablePull, PrimitiveEvadeCopying)
 {
     using char_t = typename TypeParam::first_type;
@@ -430,6 +501,142 @@ TYPED_TEST_P(TestTablePull, SkipRecord)
     ASSERT_EQ(std::make_pair(i, j), pull.get_position());
 }
 
+TYPED_TEST_P(TestTablePull, SkipRecordPlainLines)
+{
+    using char_t = typename TypeParam::first_type;
+    using string_t = std::basic_string<char_t>;
+
+    const auto str = char_helper<char_t>::str;
+
+    const auto csv = str("a,b\n"
+                         "c,d,e\r\n"
+                         "\n"
+                         "f\r\n"
+                         "\r\n"
+                         "g,\"h\ni\"\n"
+                         "j\rk,l\n"
+                         "m,n\n"
+                         "o");
+
+    // Compares skip_record with its equivalent made of operator()
+    for (const bool aware : { false, true }) {
+        for (std::size_t n = 0; n < 10; ++n) {
+            auto pull1 = make_table_pull(
+                make_csv_source(csv), TypeParam::second_type::value);
+            pull1.set_empty_physical_line_aware(aware);
+            auto pull2 = make_table_pull(
+                make_csv_source(csv), TypeParam::second_type::value);
+            pull2.set_empty_physical_line_aware(aware);
+
+            pull1.skip_record(n);
+            for (std::size_t i = 0; (i <= n) && pull2; ++i) {
+                while (pull2() && (pull2.state() == table_pull_state::field));
+            }
+            ASSERT_EQ(pull2.state(), pull1.state()) << aware << ',' << n;
+            ASSERT_EQ(pull2.get_position(), pull1.get_position())
+                << aware << ',' << n;
+            ASSERT_EQ(pull2.get_physical_position(),
+                      pull1.get_physical_position()) << aware << ',' << n;
+            ASSERT_EQ(string_t(*pull2()), string_t(*pull1()))
+                << aware << ',' << n;
+        }
+    }
+}
+
+TYPED_TEST_P(TestTablePull, NextRecord)
+{
+    using char_t = typename TypeParam::first_type;
+    using string_t = std::basic_string<char_t>;
+    using pos_t = std::pair<std::size_t, std::size_t>;
+
+    const auto str = char_helper<char_t>::str;
+
+    const auto csv = str("ab,\"c\"\"d\",e\n"
+                         "\"f\ng\",\n"
+                         "\n"
+                         "hij,\"\"\"\"\"kl\"");
+    const auto check = [str](auto&& pull) {
+        ASSERT_TRUE(pull.next_record());
+        ASSERT_EQ(table_pull_state::record_end, pull.state());
+        ASSERT_EQ(pos_t(0U, 3U), pull.get_position());
+        auto r = pull.record();
+        ASSERT_EQ(3U, r.size());
+        ASSERT_EQ(str("ab"), string_t(r[0]));
+        ASSERT_EQ(str("c\"d"), string_t(r[1]));
+        ASSERT_EQ(str("e"), string_t(r.at(2)));
+        ASSERT_THROW(r.at(3), std::out_of_range);
+
+        // Mixed with field-at-a-time pulls
+        ASSERT_EQ(str("f\ng"), string_t(*pull()));
+        ASSERT_TRUE(pull.next_record());
+        ASSERT_EQ(pos_t(1U, 2U), pull.get_position());
+        r = pull.record();
+        ASSERT_EQ(1U, r.size());
+        ASSERT_TRUE(r[0].empty());
+
+        ASSERT_TRUE(pull.next_record());
+        ASSERT_EQ(pos_t(2U, 2U), pull.get_position());
+        r = pull.record();
+        ASSERT_EQ(2U, r.size());
+        ASSERT_EQ(str("hij"), string_t(r[0]));
+        ASSERT_EQ(str("\"\"kl"), string_t(r[1]));
+        ASSERT_EQ(str("hij"), string_t(pull.record()[0]));
+
+        ASSERT_FALSE(pull.next_record());
+        ASSERT_EQ(table_pull_state::eof, pull.state());
+        ASSERT_TRUE(pull.record().empty());
+    };
+
+    check(make_table_pull(
+        make_csv_source(csv), TypeParam::second_type::value));
+    check(make_table_pull(
+        make_csv_source(indirect, csv), TypeParam::second_type::value));
+}
+
+TYPED_TEST_P(TestTablePull, NextRecordWide)
+{
+    using char_t = typename TypeParam::first_type;
+    using string_t = std::basic_string<char_t>;
+
+    const auto str = char_helper<char_t>::str;
+
+    string_t csv;
+    for (std::size_t i = 0; i < 100; ++i) {
+        csv += str(i % 2 == 0 ? "xyz," : "\"x\"\"z\",");
+    }
+    csv += str("end\n");
+    csv += csv;
+
+    auto pull = make_table_pull(
+        make_csv_source(csv), TypeParam::second_type::value);
+    for (std::size_t k = 0; k < 2; ++k) {
+        ASSERT_TRUE(pull.next_record());
+        const auto r = pull.record();
+        ASSERT_EQ(101U, r.size());
+        for (std::size_t i = 0; i < 100; ++i) {
+            ASSERT_EQ(str(i % 2 == 0 ? "xyz" : "x\"z"), string_t(r[i]))
+                << k << ',' << i;
+        }
+        ASSERT_EQ(str("end"), string_t(r[100]));
+    }
+    ASSERT_FALSE(pull.next_record());
+}
+
+TYPED_TEST_P(TestTablePull, NextRecordEmptyLines)
+{
+    using char_t = typename TypeParam::first_type;
+
+    const auto str = char_helper<char_t>::str;
+
+    auto pull = make_table_pull(make_csv_source(str("A\n\nB\n")),
+                                TypeParam::second_type::value);
+    pull.set_empty_physical_line_aware();
+    ASSERT_EQ(1U, pull.next_record().record().size());
+    ASSERT_TRUE(pull.next_record().record().empty());
+    ASSERT_EQ(1U, pull.next_record().record().size());
+    ASSERT_FALSE(pull.next_record());
+}
+
 TYPED_TEST_P(TestTablePull, Error)
 {
     using char_t = typename TypeParam::first_type;
@@ -479,6 +686,16 @@ TYPED_TEST_P(TestTablePull, EvadeCopying)
             offset += 5;
         }
     }
+    ASSERT_EQ(str("col1,col2,col3\n"
+                  "val1,val2,val3\n"), s);
+
+    // The source must not be written even when a value consists of
+    // noncontiguous pieces
+    const auto t = str("\"a\"\"b\",c\n");
+    auto pull2 = make_table_pull(make_csv_source(t));
+    ASSERT_EQ(str("a\"b"), *pull2());
+    ASSERT_EQ(str("c"), *pull2());
+    ASSERT_EQ(str("\"a\"\"b\",c\n"), t);
 }
 
 TYPED_TEST_P(TestTablePull, EvadeCopyingNonconst)
@@ -581,9 +798,11 @@ TYPED_TEST_P(TestTablePull, ToArithmetic)
 
 REGISTER_TYPED_TEST_SUITE_P(TestTablePull,
     PrimitiveBasicsOnCsv, PrimitiveBasicsOnTsv,
-    PrimitiveMove, PrimitiveEvadeCopying, PrimitiveEvadeCopyingNonconst,
-    Basics, SkipRecord, SkipField, Error, EvadeCopying, EvadeCopyingNonconst,
-    Move, ToArithmetic);
+    PrimitiveMove, PrimitiveNoQueueAllocation, PrimitiveEvadeCopying,
+    PrimitiveEvadeCopyingNonconst, Basics, SkipRecord, SkipRecordPlainLines,
+    NextRecord,
+    NextRecordWide, NextRecordEmptyLines, SkipField, Error,
+    EvadeCopying, EvadeCopyingNonconst, Move, ToArithmetic);
 
 namespace {
 
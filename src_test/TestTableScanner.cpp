@@ -102,6 +102,29 @@ TYPED_TEST(TestFieldTranslatorForArithmeticTypes, Copy)
     ASSERT_EQ(expected, values);
 }
 
+TYPED_TEST(TestFieldTranslatorForArithmeticTypes, Const)
+{
+    const auto str = char_helper<TypeParam>::str;
+
+    std::vector<int> xs;
+    auto t = make_field_translator(xs);
+    static_assert(std::is_invocable_v<decltype(t)&,
+        const TypeParam*, const TypeParam*>);
+
+    // Parsing a direct source, the translator takes the values in the
+    // source without any copies, whose terminators are not null characters
+    const auto s = str("1,23\n456,7");
+    basic_table_scanner<TypeParam> h;
+    h.set_field_scanner(0, std::ref(t));
+    try {
+        parse_csv(s /*direct*/, std::move(h));
+    } catch (const text_error& e) {
+        FAIL() << text_error_info(e);
+    }
+    ASSERT_EQ((std::vector<int>{ 1, 456 }), xs);
+    ASSERT_EQ(str("1,23\n456,7"), s);
+}
+
 template <class Ch>
 struct TestFieldTranslatorForStringTypes : BaseTest
 {};
@@ -985,6 +1008,121 @@ TYPED_TEST(TestTableScanner, Ignored)
     ASSERT_EQ(150, a.yield());
 }
 
+TYPED_TEST(TestTableScanner, WideSparse)
+{
+    using string_t = std::basic_string<TypeParam>;
+
+    const auto ch = char_helper<TypeParam>::ch;
+
+    // 1000 columns, 20 of which are scanned
+    constexpr std::size_t n = 1000;
+    std::vector<std::vector<long>> values(20);
+    basic_table_scanner<TypeParam> scanner(1U);
+    for (std::size_t k = 0; k < values.size(); ++k) {
+        scanner.set_field_scanner((k * 53 + 7) % n,
+            make_field_translator(values[k]));
+    }
+
+    string_t s;
+    for (std::size_t i = 0; i < 3; ++i) {
+        for (std::size_t j = 0; j < n; ++j) {
+            if (j > 0) {
+                s += ch(',');
+            }
+            for (const auto c : std::to_string(i * 10000 + j)) {
+                s += ch(c);
+            }
+        }
+        s += ch('\n');
+    }
+    try {
+        parse_csv(s, std::move(scanner));
+    } catch (const text_error& e) {
+        FAIL() << text_error_info(e);
+    }
+
+    for (std::size_t k = 0; k < values.size(); ++k) {
+        const long j = static_cast<long>((k * 53 + 7) % n);
+        ASSERT_EQ((std::vector<long>{ 10000 + j, 20000 + j }), values[k])
+            << k;
+    }
+}
+
+TYPED_TEST(TestTableScanner, Bind)
+{
+    using string_t = std::basic_string<TypeParam>;
+
+    const auto str = char_helper<TypeParam>::str;
+
+    for (const auto& text : { str("id,name,price\n1,apple,1.5\n2,pear,2\n"),
+                              str("price,id,name\n1.5,1,apple\n2,2,pear\n"),
+                              str("name,x,price,id,id\n"
+                                  "apple,?,1.5,1,9\npear,?,2,2,9\n") }) {
+        std::vector<int> ids;
+        std::vector<string_t> names;
+        std::vector<double> prices;
+        std::vector<int> others;
+        basic_table_scanner<TypeParam> scanner;
+        scanner.bind(str("price"), make_field_translator(prices));
+        scanner.bind(str("id"), make_field_translator(others));
+        scanner.bind(str("id"), make_field_translator(ids));    // overridden
+        scanner.bind(str("name"), make_field_translator(names));
+        scanner.bind(str("weight"), make_field_translator(others), false);
+        ASSERT_TRUE(scanner.is_in_header());
+        try {
+            parse_csv(text, std::move(scanner));
+        } catch (const text_error& e) {
+            FAIL() << text_error_info(e);
+        }
+        ASSERT_EQ((std::vector<int>{ 1, 2 }), ids);
+        ASSERT_EQ((std::vector<string_t>{ str("apple"), str("pear") }),
+                  names);
+        ASSERT_EQ((std::vector<double>{ 1.5, 2.0 }), prices);
+        ASSERT_TRUE(others.empty());
+    }
+}
+
+TYPED_TEST(TestTableScanner, BindWithHeaderRecords)
+{
+    const auto str = char_helper<TypeParam>::str;
+
+    std::vector<int> values;
+    std::vector<int> heads;
+    basic_table_scanner<TypeParam> scanner(2U);
+    scanner.bind(str("b"), make_field_translator(values));
+    scanner.set_field_scanner(0, make_field_translator(heads));
+    try {
+        parse_csv(str("a,b\n-,-\n10,20\n30,40\n"), std::move(scanner));
+    } catch (const text_error& e) {
+        FAIL() << text_error_info(e);
+    }
+    ASSERT_EQ((std::vector<int>{ 20, 40 }), values);
+    ASSERT_EQ((std::vector<int>{ 10, 30 }), heads);
+}
+
+TYPED_TEST(TestTableScanner, BindMissing)
+{
+    const auto str = char_helper<TypeParam>::str;
+
+    std::vector<int> values;
+    basic_table_scanner<TypeParam> scanner;
+    scanner.bind(str("a"), make_field_translator(values));
+    scanner.bind(str("qty"), make_field_translator(values));
+    scanner.bind(str("zone"), make_field_translator(values));
+    scanner.bind(str("opt"), make_field_translator(values), false);
+    try {
+        parse_csv(str("x,a,y\n1,2,3\n"), std::move(scanner));
+        FAIL();
+    } catch (const field_not_found& e) {
+        const std::string what = e.what();
+        ASSERT_NE(what.find("\"qty\", \"zone\""), std::string::npos)
+            << what;
+        ASSERT_EQ(what.find("opt"), std::string::npos) << what;
+        ASSERT_TRUE(e.get_physical_position()) << what;
+    }
+    ASSERT_TRUE(values.empty());
+}
+
 namespace {
 
 template <class Ch>
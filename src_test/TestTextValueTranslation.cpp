@@ -5,7 +5,12 @@
 
 #include <algorithm>
 #include <cctype>
+#include <cerrno>
+#include <clocale>
+#include <cmath>
 #include <cstddef>
+#include <cstdlib>
+#include <cstring>
 #include <deque>
 #include <iomanip>
 #include <ios>
@@ -1122,6 +1127,40 @@ TYPED_TEST(TestToArithmeticFloatingPoints, LowerLimit)
     ASSERT_FALSE(to_arithmetic<opt_t>(minn_by_10).has_value());
 }
 
+TYPED_TEST(TestToArithmeticFloatingPoints, CLocaleDecimalPoint)
+{
+    using char_t = typename TypeParam::first_type;
+    using value_t = typename TypeParam::second_type;
+    using opt_t = std::optional<value_t>;
+
+    const auto str = char_helper<char_t>::str;
+
+    // The decimal point is that of the current C locale as it is for
+    // std::strtod and its comrades
+    const std::string saved = std::setlocale(LC_NUMERIC, nullptr);
+    bool comma = false;
+    for (const char* name : { "de_DE.UTF-8", "de_DE.utf8", "de_DE",
+                              "fr_FR.UTF-8", "fr_FR.utf8", "fr_FR" }) {
+        if (std::setlocale(LC_NUMERIC, name)
+         && (*std::localeconv()->decimal_point == ',')) {
+            comma = true;
+            break;
+        }
+    }
+    if (!comma) {
+        std::setlocale(LC_NUMERIC, saved.c_str());
+        std::cerr << "No C locales have a comma for the decimal point. "
+                     "Skipping this test." << std::endl;
+        return;
+    }
+    const auto period = to_arithmetic<opt_t>(str("1.5"));
+    const auto comma_separated = to_arithmetic<opt_t>(str("1,5"));
+    std::setlocale(LC_NUMERIC, saved.c_str());
+
+    ASSERT_FALSE(period.has_value());
+    ASSERT_EQ(opt_t(static_cast<value_t>(1.5)), comma_separated);
+}
+
 struct TestToArithmeticMiscellaneous : BaseTest
 {};
 
@@ -1141,6 +1180,158 @@ TEST_F(TestToArithmeticMiscellaneous, Const)
 
 namespace {
 
+template <class Ch>
+struct bounded_chars
+{
+    const Ch* begin;
+    std::size_t length;
+
+    const Ch* c_str() const
+    {
+        return begin;
+    }
+
+    std::size_t size() const
+    {
+        return length;
+    }
+};
+
+}
+
+TEST_F(TestToArithmeticMiscellaneous, NotNullTerminated)
+{
+    const char s[] = { '1', '2', '3', '4', '.', '5', 'x' };
+    ASSERT_EQ(123, to_arithmetic<int>(bounded_chars<char>{ s, 3 }));
+    ASSERT_EQ(1234.5, to_arithmetic<double>(bounded_chars<char>{ s, 6 }));
+    ASSERT_THROW(to_arithmetic<double>(bounded_chars<char>{ s, 7 }),
+                 text_value_invalid_format);
+
+    // Inputs left to std::strtol and its comrades
+    const char t[] = { ' ', '-', '1', '2', '3', '4', '5', '6', '7', '8' };
+    ASSERT_EQ(-12, to_arithmetic<long>(bounded_chars<char>{ t, 4 }));
+    ASSERT_EQ(static_cast<unsigned long>(-123),
+              to_arithmetic<unsigned long>(bounded_chars<char>{ t + 1, 4 }));
+    const std::string u(100, '1');
+    ASSERT_THROW(to_arithmetic<long>(bounded_chars<char>{ u.data(), 90 }),
+                 text_value_out_of_range);
+}
+
+TEST_F(TestToArithmeticMiscellaneous, LongDigits)
+{
+    ASSERT_EQ(12345678LL, to_arithmetic<long long>("12345678"s));
+    ASSERT_EQ(1234567890123456LL,
+              to_arithmetic<long long>("1234567890123456"s));
+    ASSERT_EQ(-1234567890123456789LL,
+              to_arithmetic<long long>("-1234567890123456789"s));
+    ASSERT_EQ(20240101235959ULL,
+              to_arithmetic<unsigned long long>("0020240101235959"s));
+    ASSERT_EQ(std::numeric_limits<long long>::max(),
+              to_arithmetic<long long>("9223372036854775807"s));
+    ASSERT_EQ(std::numeric_limits<long long>::min(),
+              to_arithmetic<long long>("-9223372036854775808"s));
+    ASSERT_EQ(std::numeric_limits<unsigned long long>::max(),
+              to_arithmetic<unsigned long long>("18446744073709551615"s));
+    ASSERT_EQ(5LL, to_arithmetic<long long>("0000000000000000000005"s));
+
+    // A non-digit anywhere in an eight-digit chunk
+    for (std::size_t i = 0; i < 16; ++i) {
+        std::string s = "1234567890123456";
+        s[i] = ':';
+        ASSERT_THROW(to_arithmetic<long long>(s), text_value_invalid_format)
+            << s;
+        s[i] = '/';
+        ASSERT_THROW(to_arithmetic<long long>(s), text_value_invalid_format)
+            << s;
+    }
+    ASSERT_EQ(1234567890123456LL,
+              to_arithmetic<long long>("1234567890123456 "s));
+    ASSERT_THROW(to_arithmetic<long long>("9223372036854775808"s),
+                 text_value_out_of_range);
+    ASSERT_THROW(to_arithmetic<long long>("-9223372036854775809"s),
+                 text_value_out_of_range);
+    ASSERT_THROW(to_arithmetic<unsigned long long>("18446744073709551616"s),
+                 text_value_out_of_range);
+    ASSERT_THROW(to_arithmetic<int>("12345678901"s), text_value_out_of_range);
+}
+
+TEST_F(TestToArithmeticMiscellaneous, SameAsStrtod)
+{
+    for (const char* s : { "0x1p3", " +5", "+-5", "1e", "-0", "infinity",
+                           "1e-400", "4e-320", "1e400", "-1e400",
+                           "2.2250738585072014e-308", "1.7976931348623157e308",
+                           "0.1 ", "+.5e-3", "" }) {
+        char* e;
+        errno = 0;
+        const double expected = std::strtod(s, &e);
+        const bool erange = (errno == ERANGE);
+        const bool invalid = (*e != '\0') && (*e != ' ');
+        const bool empty = (e == s);
+        errno = 0;
+
+        const auto actual = to_arithmetic<std::optional<double>>(
+            std::string(s));
+        if (erange || invalid || empty) {
+            ASSERT_FALSE(actual.has_value()) << s;
+        } else {
+            ASSERT_TRUE(actual.has_value()) << s;
+            ASSERT_EQ(std::signbit(expected), std::signbit(*actual)) << s;
+            ASSERT_EQ(expected, *actual) << s;
+        }
+    }
+}
+
+TEST_F(TestToArithmeticMiscellaneous, ShortDecimals)
+{
+    const char* const ss[] = {
+        "123.45", "-0.0012", "6.02e23", "1e22", "1e23", "9007199254740993",
+        "0.1", "-0.0", "3.4028235e38", "1.17549435e-38", "12345678.9e-3",
+        "0.000000000000000000000000000000000000000000001", "1.e5", "+7.25"
+    };
+    for (const char* s : ss) {
+        const double expected_d = std::strtod(s, nullptr);
+        const float expected_f = std::strtof(s, nullptr);
+        const std::wstring w(s, s + std::strlen(s));
+
+        const auto d = to_arithmetic<double>(bounded_chars<char>{
+            s, std::strlen(s) });
+        const auto wd = to_arithmetic<double>(bounded_chars<wchar_t>{
+            w.data(), w.size() });
+        const auto f = to_arithmetic<std::optional<float>>(std::string(s));
+        ASSERT_EQ(0, std::memcmp(&expected_d, &d, sizeof d)) << s;
+        ASSERT_EQ(0, std::memcmp(&expected_d, &wd, sizeof wd)) << s;
+        errno = 0;
+        std::strtof(s, nullptr);
+        if (errno == ERANGE) {
+            ASSERT_FALSE(f.has_value()) << s;
+        } else {
+            ASSERT_TRUE(f.has_value()) << s;
+            ASSERT_EQ(0, std::memcmp(&expected_f, &*f, sizeof expected_f))
+                << s;
+        }
+    }
+    errno = 0;
+
+    const wchar_t t[] = { L'1', L'2', L'.', L'5', L'x' };
+    ASSERT_EQ(12, to_arithmetic<int>(bounded_chars<wchar_t>{ t, 2 }));
+    ASSERT_EQ(12.5, to_arithmetic<double>(bounded_chars<wchar_t>{ t, 4 }));
+    ASSERT_THROW(to_arithmetic<double>(bounded_chars<wchar_t>{ t, 5 }),
+                 text_value_invalid_format);
+    ASSERT_THROW(to_arithmetic<float>(L"1e39"s), text_value_out_of_range);
+    ASSERT_THROW(to_arithmetic<double>(L"1.5\x3000"s),
+                 text_value_invalid_format);
+}
+
+TEST_F(TestToArithmeticMiscellaneous, Errno)
+{
+    errno = EDOM;
+    ASSERT_EQ(42, to_arithmetic<int>("42"s));
+    ASSERT_EQ(-42L, to_arithmetic<long>("-42 "s));
+    ASSERT_EQ(EDOM, errno);
+}
+
+namespace {
+
 struct rvalue_handler
 {
     int operator()(invalid_format_t) &
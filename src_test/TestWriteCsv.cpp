@@ -0,0 +1,230 @@
+/**
+ * These codes are licensed under the Unlicense.
+ * http://unlicense.org
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <ios>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <commata/csv_writer.hpp>
+#include <commata/parse_csv.hpp>
+#include <commata/stored_table.hpp>
+#include <commata/write_csv.hpp>
+
+#include "BaseTest.hpp"
+
+using namespace commata;
+using namespace commata::test;
+
+namespace {
+
+using Chs = testing::Types<char, wchar_t>;
+
+template <class Ch>
+using table_t =
+    basic_stored_table<std::deque<std::vector<basic_stored_value<Ch>>>>;
+
+template <class Ch>
+table_t<Ch> make_table(std::size_t n)
+{
+    const auto str = char_helper<Ch>::str;
+    std::basic_string<Ch> s = str("id,name,remarks\n");
+    for (std::size_t i = 0; i < n; ++i) {
+        s += char_helper<Ch>::to_string(i);
+        switch (i % 4) {
+        case 0:
+            s += str(",plain,value\n");
+            break;
+        case 1:
+            s += str(",\"with,comma\",\"with \"\"quotes\"\"\r\nand lines\"\n");
+            break;
+        case 2:
+            s += str(",,\n");
+            break;
+        default:
+            // Long enough to span some chunks by itself
+            s += str(",long,");
+            s.append(i * 3, Ch('x'));
+            s += str("\n");
+            break;
+        }
+    }
+    table_t<Ch> table;
+    parse_csv(s, make_stored_table_builder(table));
+    return table;
+}
+
+template <class Ch>
+std::vector<std::vector<std::basic_string<Ch>>> to_vectors(
+    const table_t<Ch>& table)
+{
+    std::vector<std::vector<std::basic_string<Ch>>> v;
+    for (const auto& r : table.content()) {
+        auto& s = v.emplace_back();
+        for (const auto& f : r) {
+            s.emplace_back(f.cbegin(), f.cend());
+        }
+    }
+    return v;
+}
+
+// Counts the allocations, which are made in several threads
+template <class T>
+class counting_allocator
+{
+    std::atomic<std::size_t>* count_;
+
+public:
+    using value_type = T;
+
+    explicit counting_allocator(std::atomic<std::size_t>& count) noexcept :
+        count_(&count)
+    {}
+
+    template <class U>
+    counting_allocator(const counting_allocator<U>& other) noexcept :
+        count_(other.count())
+    {}
+
+    T* allocate(std::size_t n)
+    {
+        ++*count_;
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept
+    {
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    std::atomic<std::size_t>* count() const noexcept
+    {
+        return count_;
+    }
+
+    template <class U>
+    bool operator==(const counting_allocator<U>& other) const noexcept
+    {
+        return count_ == other.count();
+    }
+
+    template <class U>
+    bool operator!=(const counting_allocator<U>& other) const noexcept
+    {
+        return !(*this == other);
+    }
+};
+
+// Fails to accept chars after some amount of them
+class short_stringbuf : public std::stringbuf
+{
+    std::streamsize rest_;
+
+public:
+    explicit short_stringbuf(std::streamsize rest) :
+        rest_(rest)
+    {}
+
+protected:
+    std::streamsize xsputn(const char* s, std::streamsize n) override
+    {
+        const auto m = std::min(n, rest_);
+        rest_ -= m;
+        return std::stringbuf::xsputn(s, m);
+    }
+};
+
+}
+
+template <class Ch>
+struct TestWriteCsv : BaseTest
+{};
+
+TYPED_TEST_SUITE(TestWriteCsv, Chs);
+
+TYPED_TEST(TestWriteCsv, SameAsSequential)
+{
+    const auto str = char_helper<TypeParam>::str;
+
+    auto table = make_table<TypeParam>(150);
+    table.rewrite_value(table[3][1], str("re\"written"));
+
+    for (const auto quoting : { csv_quoting::minimal, csv_quoting::all }) {
+        for (const auto terminator : { csv_line_terminator::lf,
+                                       csv_line_terminator::crlf }) {
+            std::basic_stringbuf<TypeParam> expected;
+            csv_writer(expected, quoting, terminator)
+                .records(table.content().cbegin(), table.content().cend());
+
+            for (const std::size_t thread_count : { 1, 4, 0 }) {
+                for (const std::size_t chunk_size : { 1, 50, 0 }) {
+                    std::basic_stringbuf<TypeParam> out;
+                    write_csv(table, out, quoting, terminator,
+                        thread_count, chunk_size);
+                    ASSERT_EQ(expected.str(), out.str())
+                        << thread_count << ' ' << chunk_size;
+                }
+            }
+        }
+    }
+}
+
+TYPED_TEST(TestWriteCsv, RoundTrip)
+{
+    const auto table = make_table<TypeParam>(100);
+
+    std::basic_stringbuf<TypeParam> out;
+    write_csv(table, out, csv_quoting::minimal, csv_line_terminator::lf,
+        3, 64);
+
+    table_t<TypeParam> table2;
+    parse_csv(out.str(), make_stored_table_builder(table2));
+    ASSERT_EQ(to_vectors(table), to_vectors(table2));
+}
+
+TYPED_TEST(TestWriteCsv, Empty)
+{
+    std::basic_stringbuf<TypeParam> out;
+    write_csv(table_t<TypeParam>(), out);
+    ASSERT_TRUE(out.str().empty());
+}
+
+TYPED_TEST(TestWriteCsv, Allocator)
+{
+    const auto table = make_table<TypeParam>(50);
+
+    std::atomic<std::size_t> count(0);
+    const counting_allocator<TypeParam> a(count);
+
+    std::basic_stringbuf<TypeParam> expected;
+    write_csv(table, expected);
+
+    std::basic_stringbuf<TypeParam> out;
+    write_csv(std::allocator_arg, a, table, out,
+        csv_quoting::minimal, csv_line_terminator::lf, 2, 100);
+    ASSERT_EQ(expected.str(), out.str());
+    ASSERT_GT(count.load(), 0U);
+}
+
+struct TestWriteCsvMiscellaneous : BaseTest
+{};
+
+TEST_F(TestWriteCsvMiscellaneous, Failure)
+{
+    const auto table = make_table<char>(100);
+    for (const std::size_t thread_count : { 1, 4 }) {
+        short_stringbuf out(100);
+        ASSERT_THROW(write_csv(table, out, csv_quoting::minimal,
+                csv_line_terminator::lf, thread_count, 10),
+            std::ios_base::failure) << thread_count;
+    }
+}